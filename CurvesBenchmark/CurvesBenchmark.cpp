@@ -0,0 +1,190 @@
+///
+/// @file CurvesBenchmark.cpp Benchmarks of input type specializations against the generic template.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <time.h>
+#include "../ParamCurves/ParamCurve.h"
+#include "../ParamCurves/Interpolator.h"
+#include "../ParamCurves/LinearInterpolator.h"
+#include "../ParamCurves/CatmullRomInterpolator.h"
+
+///
+/// Wraps an input type so that it goes through the generic InterpolationRatio,
+/// as every input type did before the specializations.
+///
+template<typename T>
+class GenericInput {
+public:
+	T value;
+
+	GenericInput() { value = 0; }
+	GenericInput(T newValue) { value = newValue; }
+
+	bool operator< (const GenericInput &c2) const { return value < c2.value; }
+	bool operator<= (const GenericInput &c2) const { return value <= c2.value; }
+
+	GenericInput operator- (const GenericInput &c2) const { return GenericInput( value - c2.value ); }
+	GenericInput operator/ (const GenericInput &c2) const { return GenericInput( value / c2.value ); }
+
+	operator float() const { return (float)value; }
+};
+
+const size_t benchSize = 16;
+const int evaluations = 2000000;
+
+struct BenchResult {
+	double seconds;
+	double maxError;
+	float checksum;
+};
+
+///
+/// Evaluate a curve at inputs input(i), comparing with reference(i).
+///
+template<typename TInput, typename TInputFunction, typename TReferenceFunction>
+BenchResult bench(ParamCurve<TInput, float, benchSize> const &curve, TInputFunction input, TReferenceFunction reference) {
+	BenchResult result = { 0., 0., 0.f };
+
+	clock_t start = clock();
+	for(int i = 0; i < evaluations; ++i) {
+		result.checksum += curve.getValue(input(i));
+	}
+	result.seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	for(int i = 0; i < evaluations; i += 97) {
+		double error = (double)curve.getValue(input(i)) - reference(i);
+		if (error < 0.) error = -error;
+		if (error > result.maxError) result.maxError = error;
+	}
+
+	return result;
+}
+
+void print(char const *name, BenchResult const &specialized, BenchResult const &generic) {
+	printf("%s\n", name);
+	printf("  specialized: %8.2f ns/evaluation, max error %g\n", specialized.seconds * 1e9 / evaluations, specialized.maxError);
+	printf("  generic:     %8.2f ns/evaluation, max error %g\n", generic.seconds * 1e9 / evaluations, generic.maxError);
+}
+
+// Knots every second, starting at a large time value.
+const double timeStart = 1e5;
+
+double timeInput(int i) { return timeStart + (i % (int)((benchSize - 1) * 1000)) * .001; }
+GenericInput<double> genericTimeInput(int i) { return GenericInput<double>(timeInput(i)); }
+float timeOutput(size_t knot) { return (knot % 2) ? 1.f : -1.f; }
+
+double linearTimeReference(int i) {
+	long double position = (long double)timeInput(i) - timeStart;
+	size_t knot = (size_t)position;
+	long double ratio = position - knot;
+	return (double)(timeOutput(knot) + (timeOutput(knot + 1) - timeOutput(knot)) * ratio);
+}
+
+double catmullRomTimeReference(int i) {
+	static ParamCurve<long double, long double, benchSize> curve;
+	if (curve.getLength() == 0) {
+		long double inputs[benchSize];
+		long double outputs[benchSize];
+		for(size_t knot = 0; knot < benchSize; ++knot) {
+			inputs[knot] = timeStart + knot;
+			outputs[knot] = timeOutput(knot);
+		}
+		curve.initialize(CatmullRomInterpolator<long double, long double>::getInstance(), benchSize, inputs, outputs);
+	}
+
+	return (double)curve.getValue(timeInput(i));
+}
+
+// Knots every 1000 units.
+int integerInput(int i) { return i % (int)((benchSize - 1) * 1000); }
+GenericInput<int> genericIntegerInput(int i) { return GenericInput<int>(integerInput(i)); }
+
+double linearIntegerReference(int i) {
+	int knot = integerInput(i) / 1000;
+	double ratio = (integerInput(i) - knot * 1000) / 1000.;
+	return timeOutput(knot) + (timeOutput(knot + 1) - timeOutput(knot)) * ratio;
+}
+
+double catmullRomIntegerReference(int i) {
+	static ParamCurve<long double, long double, benchSize> curve;
+	if (curve.getLength() == 0) {
+		long double inputs[benchSize];
+		long double outputs[benchSize];
+		for(size_t knot = 0; knot < benchSize; ++knot) {
+			inputs[knot] = knot * 1000.L;
+			outputs[knot] = timeOutput(knot);
+		}
+		curve.initialize(CatmullRomInterpolator<long double, long double>::getInstance(), benchSize, inputs, outputs);
+	}
+
+	return (double)curve.getValue(integerInput(i));
+}
+
+template<typename TInput, typename TValue>
+void initialize(ParamCurve<TInput, float, benchSize> &curve, Interpolator<TInput, float>* interpolator, TValue start, TValue step) {
+	TInput inputs[benchSize];
+	float outputs[benchSize];
+	for(size_t knot = 0; knot < benchSize; ++knot) {
+		inputs[knot] = TInput(start + (TValue)knot * step);
+		outputs[knot] = timeOutput(knot);
+	}
+
+	curve.initialize(interpolator, benchSize, inputs, outputs);
+}
+
+int main(int argc, char* argv[])
+{
+	ParamCurve<double, float, benchSize> doubleCurve;
+	ParamCurve<GenericInput<double>, float, benchSize> genericDoubleCurve;
+	ParamCurve<int, float, benchSize> integerCurve;
+	ParamCurve<GenericInput<int>, float, benchSize> genericIntegerCurve;
+
+	initialize(doubleCurve, LinearInterpolator<double, float>::getInstance(), timeStart, 1.);
+	initialize(genericDoubleCurve, LinearInterpolator<GenericInput<double>, float>::getInstance(), timeStart, 1.);
+	print("Linear, double inputs around 1e5",
+		bench(doubleCurve, timeInput, linearTimeReference),
+		bench(genericDoubleCurve, genericTimeInput, linearTimeReference));
+
+	initialize(doubleCurve, CatmullRomInterpolator<double, float>::getInstance(), timeStart, 1.);
+	initialize(genericDoubleCurve, CatmullRomInterpolator<GenericInput<double>, float>::getInstance(), timeStart, 1.);
+	print("Catmull-Rom, double inputs around 1e5",
+		bench(doubleCurve, timeInput, catmullRomTimeReference),
+		bench(genericDoubleCurve, genericTimeInput, catmullRomTimeReference));
+
+	initialize(integerCurve, LinearInterpolator<int, float>::getInstance(), 0, 1000);
+	initialize(genericIntegerCurve, LinearInterpolator<GenericInput<int>, float>::getInstance(), 0, 1000);
+	print("Linear, int inputs",
+		bench(integerCurve, integerInput, linearIntegerReference),
+		bench(genericIntegerCurve, genericIntegerInput, linearIntegerReference));
+
+	initialize(integerCurve, CatmullRomInterpolator<int, float>::getInstance(), 0, 1000);
+	initialize(genericIntegerCurve, CatmullRomInterpolator<GenericInput<int>, float>::getInstance(), 0, 1000);
+	print("Catmull-Rom, int inputs",
+		bench(integerCurve, integerInput, catmullRomIntegerReference),
+		bench(genericIntegerCurve, genericIntegerInput, catmullRomIntegerReference));
+
+	return 0;
+}
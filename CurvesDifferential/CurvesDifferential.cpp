@@ -0,0 +1,54 @@
+///
+/// @file CurvesDifferential.cpp Differential tests of curve evaluation paths.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Differential.h"
+#include "../CurvesTests/TestClasses.h"
+
+///
+/// Usage: CurvesDifferential [cases] [seed]
+///
+int main(int argc, char* argv[])
+{
+	unsigned long cases = (argc > 1) ? strtoul(argv[1], 0, 10) : 20000;
+	unsigned int seed = (argc > 2) ? (unsigned int)strtoul(argv[2], 0, 10) : 12345u;
+
+	printf("Differential tests, %lu cases, seed %u\n", cases, seed);
+
+	RandomSource source(seed);
+	DifferentialReport report;
+	report.verbose = true;
+	for(unsigned long i = 0; i < cases; ++i) {
+		runDifferentialCase<float, float>(source, report);
+		runDifferentialCase<double, double>(source, report);
+		runDifferentialCase<int, float>(source, report);
+		runDifferentialCase<CompClass, CatmullRomClass>(source, report);
+	}
+
+	report.print();
+	return report.succeeded() ? 0 : 1;
+}
@@ -0,0 +1,660 @@
+///
+/// @file Differential.h Randomized differential checks of curve evaluation paths.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits>
+#include "../ParamCurves/ParamCurve.h"
+#include "../ParamCurves/Interpolator.h"
+#include "../ParamCurves/LinearInterpolator.h"
+#include "../ParamCurves/ClampInterpolator.h"
+#include "../ParamCurves/ClampUpInterpolator.h"
+#include "../ParamCurves/CatmullRomInterpolator.h"
+#include "../ParamCurves/MemoCache.h"
+#include "../ParamCurves/TimelineSampler.h"
+#include "../ParamCurves/CurveExtrema.h"
+#include "../ParamCurves/CurveComposition.h"
+
+///
+/// Pseudo random values (xorshift), reproducible from a seed.
+///
+class RandomSource {
+	unsigned int state;
+
+public:
+	RandomSource(unsigned int seed) : state(seed ? seed : 0x9e3779b9u) {}
+
+	unsigned int next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+};
+
+///
+/// Values read from a buffer, as received from a fuzzer. Returns 0 once exhausted.
+///
+class ByteSource {
+	unsigned char const *data;
+	size_t size;
+	size_t position;
+
+public:
+	ByteSource(unsigned char const *newData, size_t newSize) : data(newData), size(newSize), position(0) {}
+
+	unsigned int next() {
+		unsigned int result = 0;
+		for(int i = 0; i < 4; ++i) {
+			result <<= 8;
+			if (position < size) result |= data[position++];
+		}
+
+		return result;
+	}
+};
+
+///
+/// Distance between two floats in units in the last place.
+/// Two NaN are equal; a NaN and a number are as far apart as possible.
+///
+inline unsigned int ulpDistance(float a, float b) {
+	if (a != a || b != b) return (a != a && b != b) ? 0 : 0xffffffffu;
+	if (a == b) return 0;
+
+	// Map the bits so that integer order matches float order
+	unsigned int bitsA, bitsB;
+	memcpy(&bitsA, &a, sizeof(float));
+	memcpy(&bitsB, &b, sizeof(float));
+	bitsA = (bitsA & 0x80000000u) ? ~bitsA : bitsA | 0x80000000u;
+	bitsB = (bitsB & 0x80000000u) ? ~bitsB : bitsB | 0x80000000u;
+	return (bitsA > bitsB) ? bitsA - bitsB : bitsB - bitsA;
+}
+
+///
+/// Distance between a value and its reference, in units in the last place of
+/// TOutput at scale (the largest output of the curve), so that results
+/// cancelling down to zero are measured by the error of their operands.
+/// Two NaN are equal; a NaN and a number are as far apart as possible.
+///
+template<typename TOutput>
+unsigned int scaledUlpDistance(long double reference, long double value, long double scale) {
+	if (reference != reference || value != value) return (reference != reference && value != value) ? 0 : 0xffffffffu;
+	if (reference == value) return 0;
+
+	long double unit = scale * (long double)std::numeric_limits<TOutput>::epsilon();
+	if (unit < (long double)std::numeric_limits<TOutput>::min()) unit = (long double)std::numeric_limits<TOutput>::min();
+	long double ulp = fabsl(reference - value) / unit;
+	return (ulp < 4294967295.L) ? (unsigned int)ulp : 0xffffffffu;
+}
+
+template<typename T>
+float toFloat(T value) {
+	return (float)value;
+}
+
+///
+/// Conversion of generated values to curve inputs. Integer inputs are
+/// clamped to the range of TInput, and NaN becomes 0, to keep the conversion
+/// defined.
+///
+template<typename TInput, bool integer = std::numeric_limits<TInput>::is_integer>
+struct DifferentialInput {
+	static TInput get(float value) {
+		return TInput(value);
+	}
+};
+
+template<typename TInput>
+struct DifferentialInput<TInput, true> {
+	static TInput get(float value) {
+		if (value != value) return 0;
+		if (value <= (float)std::numeric_limits<TInput>::min()) return std::numeric_limits<TInput>::min();
+		// The maximum rounds up when converted to float, so it is compared inclusively
+		if ((float)std::numeric_limits<TInput>::max() <= value) return std::numeric_limits<TInput>::max();
+		return TInput(value);
+	}
+};
+
+///
+/// Comparison results of an evaluation path against the reference.
+///
+struct DifferentialPath {
+	char const *name;
+	unsigned int allowedUlp;
+	unsigned long comparisons;
+	unsigned long mismatches;
+	unsigned int maxUlp;
+
+	DifferentialPath(char const *newName, unsigned int newAllowedUlp)
+		: name(newName), allowedUlp(newAllowedUlp), comparisons(0), mismatches(0), maxUlp(0) {}
+
+	///
+	/// Record the comparison of a value with its expected value.
+	/// @return false if the difference is not allowed.
+	///
+	bool compare(float expected, float actual) {
+		return record(ulpDistance(expected, actual));
+	}
+
+	///
+	/// Record a difference already measured in units in the last place.
+	/// @return false if the difference is not allowed.
+	///
+	bool record(unsigned int ulp) {
+		++comparisons;
+		if (ulp > maxUlp) maxUlp = ulp;
+		if (ulp <= allowedUlp) return true;
+
+		++mismatches;
+		return false;
+	}
+
+	///
+	/// Record the check of a value against a lower bound, in units in the
+	/// last place of float at scale (see scaledUlpDistance).
+	///
+	bool compareAbove(float bound, float value, long double scale) {
+		return record((bound <= value) ? 0 : scaledUlpDistance<float>(bound, value, scale));
+	}
+
+	void print() const {
+		printf("%s: %s, %lu comparisons, %lu mismatches, max error %u ulp (%u allowed)\n",
+			mismatches ? "Failure" : "Success", name, comparisons, mismatches, maxUlp, allowedUlp);
+	}
+};
+
+///
+/// Results of all the evaluation paths checked by runDifferentialCase.
+/// To check a new evaluation path, add a member here and compare its
+/// results against the reference in runDifferentialCase.
+///
+struct DifferentialReport {
+	DifferentialPath cache;
+	DifferentialPath sampler;
+	DifferentialPath extrema;
+	DifferentialPath tightness;
+	DifferentialPath reference;
+	DifferentialPath composition;
+	bool verbose;
+
+	DifferentialReport()
+		: cache("MemoCache", 0)
+		// Tracks in constant Catmull-Rom segments keep the first value,
+		// the cubic may round differently elsewhere in the segment.
+		, sampler("TimelineSampler", 4)
+		// Ulps of float at the largest output of the curve. Roots of the
+		// derivative are found in float.
+		, extrema("CurveExtrema", 64)
+		// Ulps of float at the largest output of the curve, against the long
+		// double curve sampled 256 times per segment, which may miss part of
+		// Catmull-Rom extrema between samples.
+		, tightness("CurveExtrema tightness", 256)
+		// Ulps of the output type at the largest output of the curve. Ratios
+		// keep the precision of the input type, but terms of the Catmull-Rom
+		// cubic reach 12 times the largest output, and round in the output type.
+		, reference("Long double reference", 16)
+		// Ulps of float at the largest output of the result, which is the
+		// tolerance curves are composed with.
+		, composition("Curve composition", compositionUlp)
+		, verbose(false) {}
+
+	static const unsigned int compositionUlp = 8192;
+
+	bool succeeded() const {
+		return cache.mismatches == 0 && sampler.mismatches == 0 && extrema.mismatches == 0
+			&& tightness.mismatches == 0 && reference.mismatches == 0 && composition.mismatches == 0;
+	}
+
+	void print() const {
+		cache.print();
+		sampler.print();
+		extrema.print();
+		tightness.print();
+		reference.print();
+		composition.print();
+	}
+};
+
+///
+/// Obtain a float in [low, high].
+///
+template<typename TSource>
+float nextFloat(TSource &source, float low, float high) {
+	return low + (high - low) * ((source.next() & 0xffffff) / 16777215.f);
+}
+
+static const size_t differentialSize = 12;
+static const size_t differentialTracks = 4;
+
+///
+/// Generate a curve description: sizes from 0 to differentialSize, duplicated
+/// inputs, negative and huge ranges, large inputs with small steps, huge and
+/// tiny outputs, repeated outputs (constant segments).
+/// @return Number of knots generated.
+///
+template<typename TSource>
+size_t generateKnots(TSource &source, float *inputs, float *outputs) {
+	size_t length = source.next() % (differentialSize + 1);
+	float start, step, range;
+	switch(source.next() % 4) {
+	case 0: start = nextFloat(source, -100.f, 100.f); step = 10.f; range = 100.f; break;
+	case 1: start = nextFloat(source, -1e6f, -1e3f); step = 100.f; range = 1e4f; break;
+	case 2: start = -1e30f; step = 1e29f; range = 1e30f; break;
+	default: start = nextFloat(source, 1e5f, 1e7f); step = .01f; range = 1e-30f; break;
+	}
+
+	float input = start;
+	for(size_t i = 0; i < length; ++i) {
+		if (i > 0 && source.next() % 8 != 0) input += nextFloat(source, 0.f, step);
+		inputs[i] = input;
+
+		if (i > 0 && source.next() % 4 == 0) outputs[i] = outputs[i - 1];
+		else outputs[i] = nextFloat(source, -range, range);
+	}
+
+	return length;
+}
+
+///
+/// Generate an input to evaluate curves at: knots, values next to knots,
+/// values inside and outside the curve range, NaN.
+///
+template<typename TSource>
+float generateInput(TSource &source, float const *inputs, size_t length) {
+	if (length == 0) return nextFloat(source, -1.f, 1.f);
+
+	float left = inputs[0];
+	float right = inputs[length - 1];
+	float margin = (right - left) * .25f + 1.f;
+	switch(source.next() % 8) {
+	case 0: return inputs[source.next() % length];
+	case 1: return inputs[source.next() % length] * (1.f + 1e-7f);
+	case 2: return inputs[source.next() % length] * (1.f - 1e-7f);
+	case 3: return (source.next() % 64 == 0) ? std::numeric_limits<float>::quiet_NaN() : left - margin;
+	default: return nextFloat(source, left - margin, right + margin);
+	}
+}
+
+///
+/// Find the extrema of a curve over [left, right] by sampling: the values at
+/// both ends and at the inputs in between, the one-sided limits at those
+/// inputs, and points inside each segment (many for Catmull-Rom segments,
+/// whose extrema may lie anywhere inside).
+///
+template<size_t maxSize>
+void sampleExtrema(ParamCurve<long double, long double, maxSize> const &curve, long double left, long double right,
+	long double &minimum, long double &maximum) {
+	size_t length = curve.getLength();
+	int samples = (curve.getInterpolator() == CatmullRomInterpolator<long double, long double>::getInstance()) ? 256 : 1;
+
+	minimum = maximum = curve.getValue(left);
+	long double value = curve.getValue(right);
+	if (value < minimum) minimum = value;
+	if (maximum < value) maximum = value;
+	for(size_t i = 0; i < length; ++i) {
+		long double input = curve.getInput(i);
+		if (left <= input && input <= right) {
+			value = curve.getValue(input);
+			if (value < minimum) minimum = value;
+			if (maximum < value) maximum = value;
+		}
+		if (i + 1 == length || !(input < curve.getInput(i + 1))) continue;
+
+		long double from = (left < input) ? input : left;
+		long double to = (curve.getInput(i + 1) < right) ? curve.getInput(i + 1) : right;
+		if (!(from < to)) continue;
+
+		for(int k = 0; k <= samples; ++k) {
+			// The first and last samples are the limits at the ends of the segment
+			long double sample = (k == 0) ? nextafterl(from, to) : (k == samples) ? nextafterl(to, from) : from + (to - from) * k / samples;
+			value = curve.getValue(sample);
+			if (value < minimum) minimum = value;
+			if (maximum < value) maximum = value;
+		}
+	}
+}
+
+///
+/// Check composeCurves, sumCurves and blendCurves against evaluating the
+/// composition or combination directly, away from the knots of the curves
+/// (and, for compositions, from inputs where inner reaches the knots of outer),
+/// as the steps there are only kept up to rounding. Each track of curves is
+/// combined with a second generated curve, moved onto its inputs or outputs.
+/// Only arithmetic output types are checked, as outer curves take them as inputs.
+///
+template<typename TInput, typename TOutput, bool arithmetic = std::numeric_limits<TOutput>::is_specialized>
+struct DifferentialComposition {
+	template<typename TSource>
+	static bool run(TSource &, ParamCurve<TInput, TOutput, differentialSize> const *, float const *, size_t, DifferentialReport &) {
+		return true;
+	}
+};
+
+template<typename TInput, typename TOutput>
+struct DifferentialComposition<TInput, TOutput, true> {
+	static const size_t resultSize = 512;
+	static const size_t queries = 16;
+
+	///
+	/// Move sorted values onto [low, high], keeping their proportions.
+	///
+	static void moveOnto(float *values, size_t length, float low, float high) {
+		float first = values[0];
+		float span = values[length - 1] - first;
+		for(size_t i = 0; i < length; ++i) {
+			values[i] = (span > 0.f) ? low + (high - low) * ((values[i] - first) / span) : low;
+		}
+	}
+
+	///
+	/// Check whether value is within guard of some input of curve.
+	///
+	template<typename T, size_t maxSize>
+	static bool nearInput(ParamCurve<T, TOutput, maxSize> const &curve, long double value, long double guard) {
+		for(size_t i = 0; i < curve.getLength(); ++i) {
+			if (fabsl(value - (long double)curve.getInput(i)) <= guard) return true;
+		}
+
+		return false;
+	}
+
+	///
+	/// Largest distance to zero of the outputs of curve.
+	///
+	template<typename T, size_t maxSize>
+	static long double getScale(ParamCurve<T, TOutput, maxSize> const &curve) {
+		long double scale = 0.L;
+		for(size_t i = 0; i < curve.getLength(); ++i) {
+			if (scale < fabsl((long double)curve.getOutput(i))) scale = fabsl((long double)curve.getOutput(i));
+		}
+
+		return scale;
+	}
+
+	///
+	/// Margin kept from the inputs of curve: a fraction of their range, and of their size.
+	///
+	template<typename T, size_t maxSize>
+	static long double getGuard(ParamCurve<T, TOutput, maxSize> const &curve) {
+		long double first = (long double)curve.getInput(0);
+		long double last = (long double)curve.getInput(curve.getLength() - 1);
+		long double size = (fabsl(first) < fabsl(last)) ? fabsl(last) : fabsl(first);
+		return (last - first) / 1024.L + size / 65536.L;
+	}
+
+	template<typename TSource>
+	static bool run(TSource &source, ParamCurve<TInput, TOutput, differentialSize> const *curves,
+		float const *knotInputs, size_t length, DifferentialReport &report) {
+		Interpolator<TOutput, TOutput>* outerInterpolators[differentialTracks] = {
+			ClampInterpolator<TOutput, TOutput>::getInstance(),
+			ClampUpInterpolator<TOutput, TOutput>::getInstance(),
+			LinearInterpolator<TOutput, TOutput>::getInstance(),
+			CatmullRomInterpolator<TOutput, TOutput>::getInstance()
+		};
+		Interpolator<TInput, TOutput>* interpolators[differentialTracks] = {
+			ClampInterpolator<TInput, TOutput>::getInstance(),
+			ClampUpInterpolator<TInput, TOutput>::getInstance(),
+			LinearInterpolator<TInput, TOutput>::getInstance(),
+			CatmullRomInterpolator<TInput, TOutput>::getInstance()
+		};
+
+		float otherInputs[differentialSize];
+		float otherOutputs[differentialSize];
+		size_t otherLength = generateKnots(source, otherInputs, otherOutputs);
+		if (otherLength == 0) return true;
+
+		bool success = true;
+		for(size_t track = 0; track < differentialTracks; ++track) {
+			ParamCurve<TInput, TOutput, differentialSize> const &curve = curves[track];
+			float inputs[differentialSize];
+			TInput movedInputs[differentialSize];
+			TOutput outputs[differentialSize];
+			for(size_t i = 0; i < otherLength; ++i) outputs[i] = TOutput(otherOutputs[i]);
+
+			// Outer curve over the outputs of the track
+			float low = toFloat(curve.getOutput(0));
+			float high = low;
+			for(size_t i = 1; i < length; ++i) {
+				if (toFloat(curve.getOutput(i)) < low) low = toFloat(curve.getOutput(i));
+				if (high < toFloat(curve.getOutput(i))) high = toFloat(curve.getOutput(i));
+			}
+			memcpy(inputs, otherInputs, sizeof(inputs));
+			moveOnto(inputs, otherLength, low, high);
+			TOutput outerInputs[differentialSize];
+			for(size_t i = 0; i < otherLength; ++i) outerInputs[i] = TOutput(inputs[i]);
+			ParamCurve<TOutput, TOutput, differentialSize> outer;
+			outer.initialize(outerInterpolators[source.next() % differentialTracks], otherLength, outerInputs, outputs);
+
+			// Second curve over the inputs of the track
+			memcpy(inputs, otherInputs, sizeof(inputs));
+			moveOnto(inputs, otherLength, knotInputs[0], knotInputs[length - 1]);
+			for(size_t i = 0; i < otherLength; ++i) movedInputs[i] = DifferentialInput<TInput>::get(inputs[i]);
+			ParamCurve<TInput, TOutput, differentialSize> other;
+			other.initialize(interpolators[source.next() % differentialTracks], otherLength, movedInputs, outputs);
+
+			float weight = nextFloat(source, 0.f, 1.f);
+			for(int operation = 0; operation < 3; ++operation) {
+				long double scale = (operation == 0) ? getScale(outer) : getScale(curve) + getScale(other);
+				float tolerance = (float)scale * ((float)DifferentialReport::compositionUlp * std::numeric_limits<float>::epsilon());
+				if (tolerance < std::numeric_limits<float>::min()) tolerance = std::numeric_limits<float>::min();
+
+				ParamCurve<TInput, TOutput, resultSize> composed;
+				bool built;
+				if (operation == 0) built = composeCurves(outer, curve, tolerance, composed);
+				else if (operation == 1) built = sumCurves(curve, other, tolerance, composed);
+				else built = blendCurves(curve, other, weight, tolerance, composed);
+				if (!built) continue;
+
+				CurveCompositionFunction<TInput, TOutput, TOutput, differentialSize, differentialSize> composition(curve, outer);
+				CurveCombinationFunction<TInput, TOutput, differentialSize, differentialSize, CurveSum<TOutput> > sum(curve, other, CurveSum<TOutput>());
+				CurveCombinationFunction<TInput, TOutput, differentialSize, differentialSize, CurveBlend<TOutput> > blend(curve, other, CurveBlend<TOutput>(weight));
+				long double guard = getGuard(curve);
+				long double outerGuard = getGuard(outer);
+				for(size_t query = 0; query < queries; ++query) {
+					TInput input = DifferentialInput<TInput>::get(generateInput(source, knotInputs, length));
+					if (input != input || nearInput(curve, (long double)input, guard)) continue;
+					if (operation == 0 && nearInput(outer, (long double)curve.getValue(input), outerGuard)) continue;
+					if (operation != 0 && nearInput(other, (long double)input, guard)) continue;
+
+					// Knots of the result are only placed to the precision of TInput:
+					// accept the values the result takes a few ulps of input away
+					TInput offset = TInput(fabsl((long double)input) * 4.L * (long double)std::numeric_limits<TInput>::epsilon());
+					TInput from = TInput(input - offset);
+					TInput to = TInput(input + offset);
+					long double low = (long double)composed.getValue(from);
+					long double high = low;
+					long double nearby = (long double)composed.getValue(to);
+					if (nearby < low) low = nearby;
+					if (high < nearby) high = nearby;
+					for(size_t i = 0; i < composed.getLength(); ++i) {
+						if (composed.getInput(i) < from || to < composed.getInput(i)) continue;
+						nearby = (long double)composed.getOutput(i);
+						if (nearby < low) low = nearby;
+						if (high < nearby) high = nearby;
+					}
+
+					TOutput expected = (operation == 0) ? composition(input) : (operation == 1) ? sum(input) : blend(input);
+					TOutput value = composed.getValue(input);
+					long double reached = ((long double)expected < low) ? low : (high < (long double)expected) ? high : (long double)expected;
+					bool result = report.composition.record(scaledUlpDistance<float>((long double)expected, reached, scale));
+					if (!result && report.verbose) {
+						printf("Mismatch: length %u, track %u, operation %d, input %g, expected %g, result %g\n",
+							(unsigned int)length, (unsigned int)track, operation, toFloat(input), toFloat(expected), toFloat(value));
+					}
+					success = success && result;
+				}
+			}
+		}
+
+		return success;
+	}
+};
+
+///
+/// Check the alternative evaluation paths against the scalar interpolate()
+/// implementations, on curves generated from source. For arithmetic output
+/// types, interpolate() itself is checked against the same curves evaluated
+/// in long double, CurveExtrema against those sampled, and the compositions
+/// and combinations of the curves with DifferentialComposition.
+/// @return false if some path did not match.
+///
+template<typename TInput, typename TOutput, typename TSource>
+bool runDifferentialCase(TSource &source, DifferentialReport &report) {
+	const size_t queries = 64;
+	Interpolator<TInput, TOutput>* interpolators[differentialTracks] = {
+		ClampInterpolator<TInput, TOutput>::getInstance(),
+		ClampUpInterpolator<TInput, TOutput>::getInstance(),
+		LinearInterpolator<TInput, TOutput>::getInstance(),
+		CatmullRomInterpolator<TInput, TOutput>::getInstance()
+	};
+	Interpolator<long double, long double>* referenceInterpolators[differentialTracks] = {
+		ClampInterpolator<long double, long double>::getInstance(),
+		ClampUpInterpolator<long double, long double>::getInstance(),
+		LinearInterpolator<long double, long double>::getInstance(),
+		CatmullRomInterpolator<long double, long double>::getInstance()
+	};
+	bool checkReference = std::numeric_limits<TOutput>::is_specialized;
+
+	float knotInputs[differentialSize];
+	float knotOutputs[differentialSize];
+	size_t length = generateKnots(source, knotInputs, knotOutputs);
+
+	TInput inputs[differentialSize];
+	TOutput outputs[differentialSize];
+	long double referenceInputs[differentialSize];
+	long double referenceOutputs[differentialSize];
+	long double scale = 0.L;
+	for(size_t i = 0; i < length; ++i) {
+		inputs[i] = DifferentialInput<TInput>::get(knotInputs[i]);
+		outputs[i] = TOutput(knotOutputs[i]);
+		referenceInputs[i] = (long double)inputs[i];
+		referenceOutputs[i] = (long double)outputs[i];
+		if (scale < fabsl(referenceOutputs[i])) scale = fabsl(referenceOutputs[i]);
+	}
+
+	ParamCurve<TInput, TOutput, differentialSize> curves[differentialTracks];
+	TimelineSampler<TInput, TOutput, differentialSize, differentialTracks> sampler;
+	MemoCache<TInput, TOutput, differentialSize, 16> cache;
+	ParamCurve<long double, long double, differentialSize> references[differentialTracks];
+	for(size_t track = 0; track < differentialTracks; ++track) {
+		curves[track].initialize(interpolators[track], length, inputs, outputs);
+		references[track].initialize(referenceInterpolators[track], length, referenceInputs, referenceOutputs);
+		sampler.addTrack(curves[track]);
+	}
+
+	bool success = true;
+	for(size_t query = 0; query < queries; ++query) {
+		if (query == queries / 2) {
+			// Initialize again, reversing outputs: cached state must not survive.
+			for(size_t i = 0; i < length / 2; ++i) {
+				TOutput swap = outputs[i];
+				outputs[i] = outputs[length - 1 - i];
+				outputs[length - 1 - i] = swap;
+				long double referenceSwap = referenceOutputs[i];
+				referenceOutputs[i] = referenceOutputs[length - 1 - i];
+				referenceOutputs[length - 1 - i] = referenceSwap;
+			}
+			for(size_t track = 0; track < differentialTracks; ++track) {
+				curves[track].initialize(curves[track].getInterpolator(), length, inputs, outputs);
+				references[track].initialize(referenceInterpolators[track], length, referenceInputs, referenceOutputs);
+			}
+		}
+
+		TInput input = DifferentialInput<TInput>::get(generateInput(source, knotInputs, length));
+		sampler.sample(input);
+		for(size_t track = 0; track < differentialTracks; ++track) {
+			ParamCurve<TInput, TOutput, differentialSize> const &curve = curves[track];
+			TOutput value = curve.getInterpolator()->interpolate(input, &curve.getInput(0), &curve.getOutput(0), length);
+			float expected = toFloat(value);
+
+			bool result = report.sampler.compare(expected, toFloat(sampler.getValue(track)));
+			result = report.cache.compare(expected, toFloat(cache.getValue(curve, input))) && result;
+
+			long double referenceValue = 0.L;
+			if (checkReference && length > 0) {
+				referenceValue = references[track].getValue((long double)input);
+				result = report.reference.record(scaledUlpDistance<TOutput>(referenceValue, (long double)value, scale)) && result;
+			}
+
+			if (!result && report.verbose) {
+				printf("Mismatch: length %u, track %u, input %g, expected %g, sampler %g, reference %Lg\n",
+					(unsigned int)length, (unsigned int)track, toFloat(input), expected, toFloat(sampler.getValue(track)), referenceValue);
+			}
+			success = success && result;
+		}
+	}
+
+	if (length == 0) return success;
+
+	for(size_t track = 0; track < differentialTracks; ++track) {
+		ParamCurve<TInput, TOutput, differentialSize> const &curve = curves[track];
+		CurveExtrema<TInput, TOutput, differentialSize> extrema;
+		extrema.initialize(curve);
+
+		float left = generateInput(source, knotInputs, length);
+		float right = generateInput(source, knotInputs, length);
+		if (left != left || right != right) continue;
+		if (right < left) {
+			float swap = left;
+			left = right;
+			right = swap;
+		}
+
+		TOutput minimum, maximum;
+		extrema.getExtrema(DifferentialInput<TInput>::get(left), DifferentialInput<TInput>::get(right), minimum, maximum);
+		for(int i = 0; i <= 32; ++i) {
+			float input = (i == 32) ? right : left + (right - left) * (i / 32.f);
+			float value = toFloat(curve.getValue(DifferentialInput<TInput>::get(input)));
+			bool result = report.extrema.compareAbove(toFloat(minimum), value, scale);
+			result = report.extrema.compareAbove(-toFloat(maximum), -value, scale) && result;
+			if (!result && report.verbose) {
+				printf("Mismatch: length %u, track %u, [%g, %g] -> [%g, %g], value %g at %g\n",
+					(unsigned int)length, (unsigned int)track, left, right, toFloat(minimum), toFloat(maximum), value, input);
+			}
+			success = success && result;
+		}
+
+		if (checkReference) {
+			// The extrema must also be reached, judging by the long double curve
+			long double sampledMinimum, sampledMaximum;
+			sampleExtrema(references[track], (long double)DifferentialInput<TInput>::get(left),
+				(long double)DifferentialInput<TInput>::get(right), sampledMinimum, sampledMaximum);
+			bool result = report.tightness.record(scaledUlpDistance<float>(sampledMinimum, (long double)minimum, scale));
+			result = report.tightness.record(scaledUlpDistance<float>(sampledMaximum, (long double)maximum, scale)) && result;
+			if (!result && report.verbose) {
+				printf("Mismatch: length %u, track %u, [%g, %g] -> [%g, %g], sampled [%Lg, %Lg]\n",
+					(unsigned int)length, (unsigned int)track, left, right, toFloat(minimum), toFloat(maximum), sampledMinimum, sampledMaximum);
+			}
+			success = success && result;
+		}
+	}
+
+	return DifferentialComposition<TInput, TOutput>::run(source, curves, knotInputs, length, report) && success;
+}
@@ -31,6 +31,12 @@ SOFTWARE.
 #include "../ParamCurves/ClampInterpolator.h"
 #include "../ParamCurves/ClampUpInterpolator.h"
 #include "../ParamCurves/CatmullRomInterpolator.h"
+#include "../ParamCurves/MemoCache.h"
+#include "../ParamCurves/CurveComposition.h"
+#include "../ParamCurves/TimelineSampler.h"
+#include "../ParamCurves/CurveExtrema.h"
+#include "../ParamCurves/CurveLoader.h"
+#include "TestClasses.h"
 
 void testLinear();
 void testClamp();
@@ -41,6 +47,13 @@ void testCompClassClampUp();
 void testCompClassLinear();
 void testCatmullRomFloat();
 void testCatmullRom();
+void testMemoCache();
+void testComposition();
+void testTimelineSampler();
+void testCurveExtrema();
+void testLinearDouble();
+void testLinearInteger();
+void testCurveLoader();
 
 const size_t testsSize = 5;
 
@@ -67,6 +80,25 @@ int main(int argc, char* argv[])
 	testCatmullRomFloat();
 	testCatmullRom();
 
+	printf("\nTesting memoization cache:\n");
+	testMemoCache();
+
+	printf("\nTesting curve composition:\n");
+	testComposition();
+
+	printf("\nTesting timeline sampler:\n");
+	testTimelineSampler();
+
+	printf("\nTesting curve extrema:\n");
+	testCurveExtrema();
+
+	printf("\nTesting double and integer inputs:\n");
+	testLinearDouble();
+	testLinearInteger();
+
+	printf("\nTesting curve loader:\n");
+	testCurveLoader();
+
 	return 0;
 }
 
@@ -190,31 +222,6 @@ void testCompNonDivLinear() {
 	////check<float, CompNonDivClass, testsSize>(.5f, .5f, &curve);
 }
 
-class CompClass {
-public:
-	float value;
-
-	CompClass() { value = 0.f; }
-	CompClass(float newValue) { value = newValue; }
-
-	bool operator== (const CompClass &c2) const { return value == c2.value; }
-	bool operator< (const CompClass &c2) const { return value < c2.value; }
-	bool operator> (const CompClass &c2) const { return value > c2.value; }
-	bool operator<= (const CompClass &c2) const { return value <= c2.value; }
-	bool operator>= (const CompClass &c2) const { return value >= c2.value; }
-
-	// All this return a copy of the resulting CompClass.
-	CompClass operator+ (const CompClass &c2) const { return CompClass( value + c2.value ); }
-	CompClass operator- (const CompClass &c2) const { return CompClass( value - c2.value ); }
-	CompClass operator* (const CompClass &c2) const { return CompClass( value * c2.value ); }
-	CompClass operator/ (const CompClass &c2) const { return CompClass( value / c2.value ); }
-
-	CompClass operator* (const float &f) const { return CompClass( value * f ); }
-	CompClass operator/ (const float &f) const { return CompClass( value / f ); }
-
-	operator float() { return value; }
-};
-
 void testCompClassClamp() {
 	ParamCurve<CompClass, float, testsSize> curve;
 	
@@ -259,6 +266,10 @@ void testCompClassClampUp() {
 	check<CompClass, float, testsSize>(5.f,		16.f,	&curve);
 	check<CompClass, float, testsSize>(20.f,	16.f,	&curve);
 	check<CompClass, float, testsSize>(4.01f,	16.f,	&curve);
+
+	curve.initialize(interpolator, 1, inputs + 2, outputs + 2);
+	check<CompClass, float, testsSize>(1.f,		4.f,	&curve);
+	check<CompClass, float, testsSize>(3.f,		4.f,	&curve);
 }
 
 void testCompClassLinear() {
@@ -284,33 +295,6 @@ void testCompClassLinear() {
 	check<CompClass, float, testsSize>(4.01f,	16.f,	&curve);
 }
 
-class CatmullRomClass {
-public:
-	float value;
-
-	CatmullRomClass() { value = 0.f; }
-	CatmullRomClass(float newValue) { value = newValue; }
-
-	bool operator== (const CatmullRomClass &c2) const { return value == c2.value; }
-	bool operator< (const CatmullRomClass &c2) const { return value < c2.value; }
-	bool operator> (const CatmullRomClass &c2) const { return value > c2.value; }
-	bool operator<= (const CatmullRomClass &c2) const { return value <= c2.value; }
-	bool operator>= (const CatmullRomClass &c2) const { return value >= c2.value; }
-
-	// All this return a copy of the resulting CatmullRomClass.
-	CatmullRomClass operator+ (const CatmullRomClass &c2) const { return CatmullRomClass( value + c2.value ); }
-	CatmullRomClass operator- (const CatmullRomClass &c2) const { return CatmullRomClass( value - c2.value ); }
-	CatmullRomClass operator* (const CatmullRomClass &c2) const { return CatmullRomClass( value * c2.value ); }
-	CatmullRomClass operator/ (const CatmullRomClass &c2) const { return CatmullRomClass( value / c2.value ); }
-
-	CatmullRomClass operator* (const float &f) const { return CatmullRomClass( value * f ); }
-	CatmullRomClass operator/ (const float &f) const { return CatmullRomClass( value / f ); }
-	CatmullRomClass operator+ (const float &f) const { return CatmullRomClass( value + f ); }
-	CatmullRomClass operator- (const float &f) const { return CatmullRomClass( value - f ); }
-
-	operator float() { return value; }
-};
-
 void testCatmullRomFloat() {
 	ParamCurve<float, float, 4> curve;
 	
@@ -365,3 +349,429 @@ void testCatmullRom() {
 
 	printf("\n");
 }
+
+float evaluateTemporaryCurve(MemoCache<float, float, testsSize, 16> &cache, float scale) {
+	ParamCurve<float, float, testsSize> curve;
+	float inputs[2] = { 0.f, 1.f };
+	float outputs[2] = { 0.f, scale };
+	curve.initialize(LinearInterpolator<float, float>::getInstance(), 2, inputs, outputs);
+	return cache.getValue(curve, .5f);
+}
+
+void testMemoCache() {
+	ParamCurve<float, float, testsSize> curve;
+	float inputs[testsSize] = { 0.f, 1.f, 2.f, 3.f, 4.f };
+	float outputs[testsSize] = { 0.f, 1.f, 4.f, 9.f, 16.f };
+	curve.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+
+	MemoCache<float, float, testsSize, 16> cache;
+	bool success = true;
+	for(int pass = 0; pass < 4; ++pass) {
+		for(int level = 0; level < 4; ++level) {
+			float input = level * 1.5f;
+			success = success && almostEqual<float>(cache.getValue(curve, input), curve.getValue(input));
+		}
+	}
+
+	// Same inputs, different results: cached values must not survive initialize
+	float newOutputs[testsSize] = { 16.f, 9.f, 4.f, 1.f, 0.f };
+	curve.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, newOutputs);
+	for(int level = 0; level < 4; ++level) {
+		float input = level * 1.5f;
+		success = success && almostEqual<float>(cache.getValue(curve, input), curve.getValue(input));
+	}
+
+	printf("%s: cached values match getValue\n", success ? "Success" : "Failure");
+	printf("%s: %lu hits, %lu misses (hit rate %f)\n",
+		(cache.getHits() == 12 && cache.getMisses() == 8) ? "Success" : "Failure",
+		cache.getHits(), cache.getMisses(), cache.getHitRate());
+
+	// A curve built where a dead one was must not get its cached values
+	float first = evaluateTemporaryCurve(cache, 100.f);
+	float second = evaluateTemporaryCurve(cache, 1.f);
+	printf("%s: new curve at a reused address -> %f, %f\n",
+		(almostEqual<float>(first, 50.f) && almostEqual<float>(second, .5f)) ? "Success" : "Failure", first, second);
+
+	// Assigned curves carry their contents, not those cached for the target
+	ParamCurve<float, float, testsSize> a;
+	ParamCurve<float, float, testsSize> b;
+	float sevens[testsSize] = { 7.f, 7.f, 7.f, 7.f, 7.f };
+	a.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+	b.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, sevens);
+	cache.getValue(a, .5f);
+	a = b;
+	float assigned = cache.getValue(a, .5f);
+	printf("%s: assigned curve -> %f\n", almostEqual<float>(assigned, a.getValue(.5f)) ? "Success" : "Failure", assigned);
+
+	// Curves sharing a cache must not compete for the entries of the same inputs.
+	// Where entries collide depends on the addresses of the curves, so the hit
+	// rate is averaged over several groups of curves, each with its own cache.
+	const size_t groups = 8;
+	const size_t sharing = 4;
+	static ParamCurve<float, float, testsSize> shared[groups * sharing];
+	float hitRate = 0.f;
+	for(size_t group = 0; group < groups; ++group) {
+		ParamCurve<float, float, testsSize> *curves = shared + group * sharing;
+		for(size_t i = 0; i < sharing; ++i) {
+			curves[i].initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, i % 2 ? outputs : newOutputs);
+		}
+
+		MemoCache<float, float, testsSize> sharedCache;
+		for(int pass = 0; pass < 10; ++pass) {
+			for(size_t i = 0; i < sharing; ++i) {
+				for(int level = 0; level < 8; ++level) {
+					success = success && almostEqual<float>(sharedCache.getValue(curves[i], (float)level), curves[i].getValue((float)level));
+				}
+			}
+		}
+		hitRate += sharedCache.getHitRate() / groups;
+	}
+
+	printf("%s: %u curves sharing a cache, average hit rate %f\n",
+		(success && hitRate >= .3f) ? "Success" : "Failure", (unsigned int)sharing, hitRate);
+}
+
+///
+/// User interpolator claiming to clamp while interpolating linearly, as the mode
+/// of interpolators other than the built-in ones is not to be trusted.
+///
+class MislabeledInterpolator : public Interpolator<float, float> {
+public:
+	MislabeledInterpolator() { interpolation = interpolationClamp; }
+
+	float interpolate(float input, float const *inputs, float const *outputs, size_t size) {
+		return LinearInterpolator<float, float>::getInstance()->interpolate(input, inputs, outputs, size);
+	}
+};
+
+template<typename TInput, typename TOutput, size_t size, typename TFunction>
+bool checkCurve(char const *name, ParamCurve<TInput, TOutput, size> const &curve, TFunction const &expected, TInput left, TInput right, float tolerance) {
+	float maxError = 0.f;
+	for(int i = 0; i <= 1000; ++i) {
+		TInput input = left + (right - left) * (i / 1000.f);
+		float error = (float)(curve.getValue(input) - expected(input));
+		if (error < 0.f) error = -error;
+		if (error > maxError) maxError = error;
+	}
+
+	bool result = maxError <= tolerance;
+	printf("%s: %s, %u knots, max error %f\n", result ? "Success" : "Failure", name, (unsigned int)curve.getLength(), maxError);
+	return result;
+}
+
+void testComposition() {
+	ParamCurve<float, float, testsSize> inner;
+	float innerInputs[testsSize] = { 0.f, 1.f, 2.f, 3.f, 4.f };
+	float innerOutputs[testsSize] = { 0.f, 2.f, 1.f, 1.f, 4.f };
+	inner.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, innerInputs, innerOutputs);
+
+	ParamCurve<float, float, testsSize> outer;
+	float outerInputs[testsSize] = { -1.f, .5f, 1.5f, 1.5f, 3.f };
+	float outerOutputs[testsSize] = { 2.f, 3.f, 0.f, 1.f, 5.f };
+	outer.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, outerInputs, outerOutputs);
+
+	ParamCurve<float, float, 32> composed;
+	CurveCompositionFunction<float, float, float, testsSize, testsSize> chain(inner, outer);
+	composeCurves(outer, inner, 0.f, composed);
+	checkCurve("linear after linear", composed, chain, -1.f, 5.f, .0001f);
+
+	// Integer inputs keep the values at the integers around crossings
+	ParamCurve<int, float, testsSize> integerInner;
+	int integerInputs[testsSize] = { -23, -10, 0, 7, 30 };
+	integerInner.initialize(LinearInterpolator<int, float>::getInstance(), testsSize, integerInputs, innerOutputs);
+	ParamCurve<int, float, 32> integerComposed;
+	CurveCompositionFunction<int, float, float, testsSize, testsSize> integerChain(integerInner, outer);
+	composeCurves(outer, integerInner, 0.f, integerComposed);
+	checkCurve("linear after linear, integer inputs", integerComposed, integerChain, -30, 40, .0001f);
+
+	outer.initialize(ClampInterpolator<float, float>::getInstance(), testsSize, outerInputs, outerOutputs);
+	composeCurves(outer, inner, 0.f, composed);
+	checkCurve("clamp after linear", composed, chain, -1.f, 5.f, .0001f);
+	composeCurves(outer, integerInner, 0.f, integerComposed);
+	checkCurve("clamp after linear, integer inputs", integerComposed, integerChain, -30, 40, .0001f);
+
+	float smoothInputs[testsSize] = { -1.f, .5f, 1.5f, 2.f, 3.f };
+	outer.initialize(CatmullRomInterpolator<float, float>::getInstance(), testsSize, smoothInputs, outerOutputs);
+	ParamCurve<float, float, 128> sampled;
+	composeCurves(outer, inner, .01f, sampled);
+	checkCurve("Catmull-Rom after linear", sampled, chain, -1.f, 5.f, .01f);
+
+	// Outer knots must not alias with the points checked between inner knots
+	ParamCurve<float, float, 2> ramp;
+	float rampInputs[2] = { 0.f, 1.f };
+	float rampOutputs[2] = { 0.f, 8.f };
+	ramp.initialize(LinearInterpolator<float, float>::getInstance(), 2, rampInputs, rampOutputs);
+	ParamCurve<float, float, 9> wave;
+	float waveInputs[9] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f };
+	float waveOutputs[9] = { 0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f };
+	wave.initialize(CatmullRomInterpolator<float, float>::getInstance(), 9, waveInputs, waveOutputs);
+	ParamCurve<float, float, 256> waved;
+	CurveCompositionFunction<float, float, float, 2, 9> waveChain(ramp, wave);
+	composeCurves(wave, ramp, .01f, waved);
+	checkCurve("Catmull-Rom waves after linear", waved, waveChain, -.5f, 1.5f, .01f);
+
+	CurveCombinationFunction<float, float, 9, 2, CurveSum<float> > waveSum(wave, ramp, CurveSum<float>());
+	sumCurves(wave, ramp, .01f, waved);
+	checkCurve("Catmull-Rom waves sum", waved, waveSum, -1.f, 9.f, .01f);
+
+	// Inner knots on duplicated outer inputs keep the side inner arrives from and leaves to
+	ParamCurve<float, float, 3> peak;
+	float peakInputs[3] = { 0.f, 1.f, 2.f };
+	float peakOutputs[3] = { -1.f, 0.f, -1.f };
+	peak.initialize(LinearInterpolator<float, float>::getInstance(), 3, peakInputs, peakOutputs);
+	ParamCurve<float, float, 3> cliff;
+	float cliffInputs[3] = { -1.f, 0.f, 0.f };
+	float cliffOutputs[3] = { 0.f, -2.f, 5.f };
+	cliff.initialize(LinearInterpolator<float, float>::getInstance(), 3, cliffInputs, cliffOutputs);
+	CurveCompositionFunction<float, float, float, 3, 3> peakChain(peak, cliff);
+	composeCurves(cliff, peak, 0.f, composed);
+	checkCurve("linear after linear, inner knot on a step", composed, peakChain, -.3f, 2.6f, .0001f);
+
+	ParamCurve<float, float, 3> valley;
+	float valleyInputs[3] = { 1.f, 5.85f, 10.3f };
+	float valleyOutputs[3] = { 1.25f, 0.f, .25f };
+	valley.initialize(LinearInterpolator<float, float>::getInstance(), 3, valleyInputs, valleyOutputs);
+	ParamCurve<float, float, 2> stair;
+	float stairInputs[2] = { 0.f, 0.f };
+	float stairOutputs[2] = { -2.3f, -1.35f };
+	stair.initialize(ClampInterpolator<float, float>::getInstance(), 2, stairInputs, stairOutputs);
+	CurveCompositionFunction<float, float, float, 3, 2> valleyChain(valley, stair);
+	composeCurves(stair, valley, 0.f, composed);
+	checkCurve("clamp after linear, inner knot on a step", composed, valleyChain, 0.f, 11.f, .0001f);
+
+	// Catmull-Rom inner overshoots its knots
+	ParamCurve<float, float, 4> swing;
+	float swingInputs[4] = { -4.f, 1.1f, 6.15f, 6.75f };
+	float swingOutputs[4] = { -.55f, -2.6f, 0.f, -4.45f };
+	swing.initialize(CatmullRomInterpolator<float, float>::getInstance(), 4, swingInputs, swingOutputs);
+	ParamCurve<float, float, 2> slope;
+	float slopeInputs[2] = { 0.f, 1.2f };
+	float slopeOutputs[2] = { -1.55f, 2.4f };
+	slope.initialize(LinearInterpolator<float, float>::getInstance(), 2, slopeInputs, slopeOutputs);
+	CurveCompositionFunction<float, float, float, 4, 2> swingChain(swing, slope);
+	composeCurves(slope, swing, .01f, waved);
+	checkCurve("linear after Catmull-Rom", waved, swingChain, -5.f, 8.f, .01f);
+
+	// Steps of outer reached between inner knots cannot get within tolerance
+	float rampUpOutputs[3] = { 0.f, 1.f, 2.f };
+	swing.initialize(CatmullRomInterpolator<float, float>::getInstance(), 3, peakInputs, rampUpOutputs);
+	float stepInputs[2] = { .5f, .5f };
+	float stepOutputs[2] = { 0.f, 1.f };
+	slope.initialize(LinearInterpolator<float, float>::getInstance(), 2, stepInputs, stepOutputs);
+	bool reached = composeCurves(slope, swing, .01f, waved);
+	printf("%s: composition reports tolerance not reached\n", reached ? "Failure" : "Success");
+
+	MislabeledInterpolator mislabeled;
+	outer.initialize(&mislabeled, testsSize, smoothInputs, outerOutputs);
+	composeCurves(outer, inner, .01f, sampled);
+	checkCurve("user interpolator after linear", sampled, chain, -1.f, 5.f, .01f);
+
+	outer.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, outerInputs, outerOutputs);
+	ParamCurve<float, float, 16> combined;
+	CurveCombinationFunction<float, float, testsSize, testsSize, CurveSum<float> > sum(inner, outer, CurveSum<float>());
+	sumCurves(inner, outer, 0.f, combined);
+	checkCurve("linear sum", combined, sum, -2.f, 5.f, .0001f);
+
+	CurveCombinationFunction<float, float, testsSize, testsSize, CurveBlend<float> > blend(inner, outer, CurveBlend<float>(.25f));
+	blendCurves(inner, outer, .25f, 0.f, combined);
+	checkCurve("linear blend", combined, blend, -2.f, 5.f, .0001f);
+
+	// Clamped curves keep the value after duplicated first inputs
+	ParamCurve<float, float, 3> stepA;
+	float stepAInputs[3] = { 0.f, 0.f, 2.f };
+	float stepAOutputs[3] = { 1.f, 2.f, 5.f };
+	stepA.initialize(ClampInterpolator<float, float>::getInstance(), 3, stepAInputs, stepAOutputs);
+	ParamCurve<float, float, 2> stepB;
+	float stepBInputs[2] = { 1.f, 3.f };
+	float stepBOutputs[2] = { 10.f, 20.f };
+	stepB.initialize(ClampInterpolator<float, float>::getInstance(), 2, stepBInputs, stepBOutputs);
+	CurveCombinationFunction<float, float, 3, 2, CurveSum<float> > stepSum(stepA, stepB, CurveSum<float>());
+	sumCurves(stepA, stepB, 0.f, combined);
+	checkCurve("clamp sum, duplicated first input", combined, stepSum, -1.f, 4.f, .0001f);
+
+	ParamCurve<float, float, 2> tooSmall;
+	bool fits = composeCurves(outer, inner, 0.f, tooSmall);
+	printf("%s: composition reports lack of room\n", fits ? "Failure" : "Success");
+}
+
+void testTimelineSampler() {
+	const size_t tracksSize = 4;
+	ParamCurve<float, float, testsSize> tracks[tracksSize];
+	float inputs[testsSize] = { 0.f, .5f, 1.5f, 2.f, 5.f };
+	float outputs[testsSize] = { 4.f, 3.f, 4.f, 5.f, 5.f };
+	tracks[0].initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+	tracks[1].initialize(ClampInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+	tracks[2].initialize(ClampUpInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+	tracks[3].initialize(CatmullRomInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+
+	TimelineSampler<float, float, testsSize, tracksSize> sampler;
+	for(size_t track = 0; track < tracksSize; ++track) {
+		sampler.addTrack(tracks[track]);
+	}
+
+	bool success = true;
+	size_t skipped = 0;
+	for(int step = 0; step <= 140; ++step) {
+		// Forward, then backward, then jumping around
+		float time = (step <= 70) ? step * .1f - 1.f : (step <= 100) ? 6.f - (step - 70) * .2f : ((step * 37) % 70) * .1f - 1.f;
+		if (step == 120) tracks[0].initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, inputs);
+
+		sampler.sample(time);
+		skipped += sampler.getSkippedCount();
+		for(size_t track = 0; track < tracksSize; ++track) {
+			success = success && almostEqual<float>(sampler.getValue(track), tracks[track].getValue(time));
+		}
+	}
+
+	printf("%s: sampled values match getValue\n", success ? "Success" : "Failure");
+	printf("%s: %u evaluations skipped in constant segments\n", skipped > 0 ? "Success" : "Failure", (unsigned int)skipped);
+}
+
+void testCurveExtrema() {
+	const size_t modesSize = 4;
+	char const *names[modesSize] = { "clamp", "clamp up", "linear", "Catmull-Rom" };
+	Interpolator<float, float>* interpolators[modesSize] = {
+		ClampInterpolator<float, float>::getInstance(),
+		ClampUpInterpolator<float, float>::getInstance(),
+		LinearInterpolator<float, float>::getInstance(),
+		CatmullRomInterpolator<float, float>::getInstance()
+	};
+	float inputs[testsSize] = { 0.f, .5f, 1.5f, 1.5f, 5.f };
+	float outputs[testsSize] = { 4.f, 2.f, 4.5f, 5.f, 1.f };
+	float intervals[][2] = { { -1.f, 6.f }, { .2f, .4f }, { .25f, 1.f }, { 1.f, 3.f }, { 1.5f, 4.f }, { 3.f, .1f }, { 5.f, 5.f }, { -2.f, 0.f } };
+	const size_t intervalsSize = sizeof(intervals) / sizeof(intervals[0]);
+
+	for(size_t mode = 0; mode < modesSize; ++mode) {
+		ParamCurve<float, float, testsSize> curve;
+		curve.initialize(interpolators[mode], testsSize, inputs, outputs);
+		CurveExtrema<float, float, testsSize> extrema;
+		extrema.initialize(curve);
+
+		bool success = true;
+		for(size_t interval = 0; interval < intervalsSize; ++interval) {
+			float left = intervals[interval][0];
+			float right = intervals[interval][1];
+			float minimum, maximum;
+			extrema.getExtrema(left, right, minimum, maximum);
+
+			float sampledMinimum = curve.getValue(left);
+			float sampledMaximum = sampledMinimum;
+			for(int i = 0; i <= 10000; ++i) {
+				float value = curve.getValue(left + (right - left) * (i / 10000.f));
+				if (value < sampledMinimum) sampledMinimum = value;
+				if (sampledMaximum < value) sampledMaximum = value;
+			}
+
+			// Sampling may only miss extrema, by a little
+			bool result = minimum <= sampledMinimum + .0001f && sampledMaximum <= maximum + .0001f
+				&& (almostEqual<float>(minimum, sampledMinimum) || sampledMinimum - minimum < .01f)
+				&& (almostEqual<float>(maximum, sampledMaximum) || maximum - sampledMaximum < .01f);
+			if (!result) {
+				printf("Failure: %s [%f, %f] -> [%f, %f] != [%f, %f]\n", names[mode], left, right, minimum, maximum, sampledMinimum, sampledMaximum);
+			}
+			success = success && result;
+		}
+
+		printf("%s: %s extrema match sampled values\n", success ? "Success" : "Failure", names[mode]);
+	}
+
+	// Extrema must follow the contents of an assigned curve
+	ParamCurve<float, float, testsSize> a;
+	ParamCurve<float, float, testsSize> b;
+	float high[testsSize] = { 5.f, 9.f, 6.f, 7.f, 8.f };
+	a.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, outputs);
+	b.initialize(LinearInterpolator<float, float>::getInstance(), testsSize, inputs, high);
+	CurveExtrema<float, float, testsSize> extrema;
+	extrema.initialize(a);
+	a = b;
+	float minimum, maximum;
+	extrema.getExtrema(-1.f, 6.f, minimum, maximum);
+	printf("%s: assigned curve extrema [%f, %f]\n", (minimum == 5.f && maximum == 9.f) ? "Success" : "Failure", minimum, maximum);
+
+	MislabeledInterpolator mislabeled;
+	a.initialize(&mislabeled, testsSize, inputs, outputs);
+	bool answered = extrema.getExtrema(-1.f, 6.f, minimum, maximum);
+	printf("%s: no extrema for user interpolators\n", answered ? "Failure" : "Success");
+}
+
+void testLinearDouble() {
+	// Ratios in float can not tell apart inputs this close to such a large one
+	ParamCurve<double, double, 3> curve;
+	double inputs[3] = { 1e7, 1e7 + 1e-3, 1e7 + 2e-3 };
+	double outputs[3] = { 0., 1., 0. };
+	curve.initialize(LinearInterpolator<double, double>::getInstance(), 3, inputs, outputs);
+
+	check<double, double, 3>(1e7 + 2.5e-4,	.25,	&curve);
+	check<double, double, 3>(1e7 + 1.5e-3,	.5,		&curve);
+
+	curve.initialize(CatmullRomInterpolator<double, double>::getInstance(), 3, inputs, outputs);
+	check<double, double, 3>(1e7 + 1e-3,	1.,		&curve);
+	check<double, double, 3>(1e7 + 5e-4,	.5625,	&curve);
+}
+
+void testLinearInteger() {
+	// Integer division would truncate all ratios to 0
+	ParamCurve<int, float, 3> curve;
+	int inputs[3] = { -10, 10, 30 };
+	float outputs[3] = { 0.f, 4.f, 2.f };
+	curve.initialize(LinearInterpolator<int, float>::getInstance(), 3, inputs, outputs);
+
+	check<int, float, 3>(-20,	0.f,	&curve);
+	check<int, float, 3>(-5,	1.f,	&curve);
+	check<int, float, 3>(0,		2.f,	&curve);
+	check<int, float, 3>(25,	2.5f,	&curve);
+	check<int, float, 3>(40,	2.f,	&curve);
+
+	// Differences wider than int holds
+	int wideInputs[3] = { -2000000000, 2000000000, 2100000000 };
+	curve.initialize(LinearInterpolator<int, float>::getInstance(), 3, wideInputs, outputs);
+
+	check<int, float, 3>(-1000000000,	1.f,	&curve);
+	check<int, float, 3>(0,				2.f,	&curve);
+	check<int, float, 3>(2050000000,	3.f,	&curve);
+}
+
+class CountingBaker : public CurveBaker<float, float, testsSize> {
+public:
+	std::atomic<int> count;
+
+	CountingBaker() : count(0) {}
+
+	void bake(ParamCurve<float, float, testsSize> const &, size_t) { ++count; }
+};
+
+void testCurveLoader() {
+	const size_t curvesSize = 200;
+	static ParamCurve<float, float, testsSize> curves[curvesSize];
+	// One more knot than fits, for the curves of invalid length
+	float inputs[testsSize + 1] = { 0.f, .5f, 1.5f, 2.f, 5.f, 6.f };
+	float unsorted[testsSize + 1] = { 0.f, 1.5f, .5f, 2.f, 5.f, 6.f };
+	CountingBaker baker;
+
+	for(size_t workers = 0; workers <= 4; workers += 4) {
+		CurveLoader<float, float, testsSize> loader(workers);
+		size_t handles[curvesSize];
+		for(size_t i = 0; i < curvesSize; ++i) {
+			float outputs[testsSize + 1] = { (float)i, 0.f, 0.f, 0.f, 0.f, 0.f };
+			handles[i] = loader.load(curves[i], LinearInterpolator<float, float>::getInstance(),
+				(i % 50 == 49) ? testsSize + 1 : testsSize, (i % 50 == 48) ? unsorted : inputs, outputs, &baker);
+		}
+
+		// Curves needed first, maybe before any worker gets to them
+		bool success = loader.wait(handles[curvesSize - 1]) == loadInvalidLength
+			&& loader.wait(handles[curvesSize - 2]) == loadUnsorted
+			&& loader.wait(handles[curvesSize - 3]) == loadReady
+			&& curves[curvesSize - 3].getValue(-1.f) == (float)(curvesSize - 3);
+
+		loader.waitAll();
+		for(size_t i = 0; i < curvesSize; ++i) {
+			t_loadStatus expected = (i % 50 == 49) ? loadInvalidLength : (i % 50 == 48) ? loadUnsorted : loadReady;
+			success = success && loader.getStatus(handles[i]) == expected;
+			if (expected == loadReady) success = success && curves[i].getValue(-1.f) == (float)i;
+		}
+
+		printf("%s: %u curves loaded with %u workers\n", success ? "Success" : "Failure", (unsigned int)curvesSize, (unsigned int)workers);
+	}
+
+	printf("%s: %d curves baked\n", baker.count == 2 * (curvesSize - 8) ? "Success" : "Failure", (int)baker.count);
+}
@@ -0,0 +1,85 @@
+///
+/// @file TestClasses.h Value classes used as curve inputs and outputs in tests.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+///
+/// Input type with the operators required by all interpolators.
+///
+class CompClass {
+public:
+	float value;
+
+	CompClass() { value = 0.f; }
+	CompClass(float newValue) { value = newValue; }
+
+	bool operator== (const CompClass &c2) const { return value == c2.value; }
+	bool operator< (const CompClass &c2) const { return value < c2.value; }
+	bool operator> (const CompClass &c2) const { return value > c2.value; }
+	bool operator<= (const CompClass &c2) const { return value <= c2.value; }
+	bool operator>= (const CompClass &c2) const { return value >= c2.value; }
+
+	// All this return a copy of the resulting CompClass.
+	CompClass operator+ (const CompClass &c2) const { return CompClass( value + c2.value ); }
+	CompClass operator- (const CompClass &c2) const { return CompClass( value - c2.value ); }
+	CompClass operator* (const CompClass &c2) const { return CompClass( value * c2.value ); }
+	CompClass operator/ (const CompClass &c2) const { return CompClass( value / c2.value ); }
+
+	CompClass operator* (const float &f) const { return CompClass( value * f ); }
+	CompClass operator/ (const float &f) const { return CompClass( value / f ); }
+
+	operator float() { return value; }
+};
+
+///
+/// Output type with the operators required by all interpolators.
+///
+class CatmullRomClass {
+public:
+	float value;
+
+	CatmullRomClass() { value = 0.f; }
+	CatmullRomClass(float newValue) { value = newValue; }
+
+	bool operator== (const CatmullRomClass &c2) const { return value == c2.value; }
+	bool operator< (const CatmullRomClass &c2) const { return value < c2.value; }
+	bool operator> (const CatmullRomClass &c2) const { return value > c2.value; }
+	bool operator<= (const CatmullRomClass &c2) const { return value <= c2.value; }
+	bool operator>= (const CatmullRomClass &c2) const { return value >= c2.value; }
+
+	// All this return a copy of the resulting CatmullRomClass.
+	CatmullRomClass operator+ (const CatmullRomClass &c2) const { return CatmullRomClass( value + c2.value ); }
+	CatmullRomClass operator- (const CatmullRomClass &c2) const { return CatmullRomClass( value - c2.value ); }
+	CatmullRomClass operator* (const CatmullRomClass &c2) const { return CatmullRomClass( value * c2.value ); }
+	CatmullRomClass operator/ (const CatmullRomClass &c2) const { return CatmullRomClass( value / c2.value ); }
+
+	CatmullRomClass operator* (const float &f) const { return CatmullRomClass( value * f ); }
+	CatmullRomClass operator/ (const float &f) const { return CatmullRomClass( value / f ); }
+	CatmullRomClass operator+ (const float &f) const { return CatmullRomClass( value + f ); }
+	CatmullRomClass operator- (const float &f) const { return CatmullRomClass( value - f ); }
+
+	operator float() { return value; }
+};
@@ -26,6 +26,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <math.h>
 #include "Interpolator.h"
 
 ///
@@ -37,7 +38,8 @@ SOFTWARE.
 /// TInput operator-(TInput&)
 /// TInput operator/(TInput&)
 /// @tparam TOutput Output values type. Required operators:
-/// TOutput operator*(float&)
+/// TOutput operator*(float&), or operator*(double&) for double inputs.
+/// @see InterpolationRatio for the precision of each input type.
 ///
 template<typename TInput, typename TOutput>
 class CatmullRomInterpolator : public Interpolator<TInput, TOutput> {
@@ -49,6 +51,98 @@ public:
 		return &instance;
 	}
 
+	///
+	/// Calculate the output at a ratio (0 to 1) of the segment starting at index.
+	///
+	template<typename TRatio>
+	static TOutput interpolateRatio(TRatio ratio, size_t index, TOutput const *outputs, size_t size) {
+		size_t i = index;
+		// First control point
+		TOutput c1 = (i > 0) ? outputs[i-1] : outputs[i];
+		// First point
+		TOutput v1 = outputs[i];
+		// Second point
+		TOutput v2 = (i < size - 1) ? outputs[i+1] : outputs[size-1];
+		// Second control point
+		TOutput c2 = (i < size - 2) ? outputs[i+2] : outputs[size-1];
+
+		return .5f * ((2.f * v1)
+			+ (v2 - c1) * ratio
+			+ (2.f * c1 - 5.f * v1 + 4.f * v2 - c2) * ratio * ratio
+			+ (3.f * v1 - c1 - 3.f * v2 + c2) * ratio * ratio * ratio);
+
+
+		////return c1 * ((-ratio + 2.f) * ratio - 1.f) * ratio * .5f
+		////	+ v1 * (((3.f * ratio - 5.f) * ratio) * ratio + 2.f) * .5f
+		////	+ v2 * ((-3.f * ratio + 4.f) * ratio + 1.f) * ratio * .5f
+		////	+ c2 * ((ratio - 1.f) * ratio * ratio) * .5f;
+	}
+
+	///
+	/// Calculate the output for an input inside the segment starting at index,
+	/// that is, inputs[index] <= input < inputs[index+1].
+	///
+	static TOutput interpolateSegment(TInput input, size_t index, TInput const *inputs, TOutput const *outputs, size_t size) {
+		typename InterpolationRatio<TInput>::type ratio = InterpolationRatio<TInput>::get(input, inputs[index], inputs[index+1]);
+		return interpolateRatio(ratio, index, outputs, size);
+	}
+
+	///
+	/// Find the local extrema inside the segment starting at index, as the roots
+	/// of the derivative of the cubic. Requires TOutput to be convertible to float.
+	/// @param ratios Receives the ratios (between 0 and 1, excluded) of the extrema, sorted.
+	/// @return Number of extrema found: 0, 1 or 2.
+	///
+	static size_t findExtrema(size_t index, TOutput const *outputs, size_t size, float ratios[2]) {
+		size_t i = index;
+		TOutput c1 = (i > 0) ? outputs[i-1] : outputs[i];
+		TOutput v1 = outputs[i];
+		TOutput v2 = (i < size - 1) ? outputs[i+1] : outputs[size-1];
+		TOutput c2 = (i < size - 2) ? outputs[i+2] : outputs[size-1];
+
+		// Derivative: b1 + 2 * b2 * ratio + 3 * b3 * ratio^2 (halved)
+		float b1 = (float)(v2 - c1);
+		float b2 = (float)(2.f * c1 - 5.f * v1 + 4.f * v2 - c2);
+		float b3 = (float)(3.f * v1 - c1 - 3.f * v2 + c2);
+		// Scale down so that huge outputs do not overflow the discriminant
+		float scale = fabsf(b1);
+		if (fabsf(b2) > scale) scale = fabsf(b2);
+		if (fabsf(b3) > scale) scale = fabsf(b3);
+		if (!(scale > 0.f)) return 0;
+
+		float a = 3.f * (b3 / scale);
+		float b = 2.f * (b2 / scale);
+		float c = b1 / scale;
+
+		float roots[2];
+		size_t rootCount = 0;
+		if (a == 0.f) {
+			if (b != 0.f) roots[rootCount++] = -c / b;
+		}
+		else {
+			float discriminant = b * b - 4.f * a * c;
+			if (discriminant >= 0.f) {
+				// Stable form, avoiding cancellation between b and the root
+				float q = -.5f * (b + ((b < 0.f) ? -sqrtf(discriminant) : sqrtf(discriminant)));
+				roots[rootCount++] = q / a;
+				if (q != 0.f) roots[rootCount++] = c / q;
+			}
+		}
+
+		size_t count = 0;
+		for(size_t r = 0; r < rootCount; ++r) {
+			if (0.f < roots[r] && roots[r] < 1.f) ratios[count++] = roots[r];
+		}
+
+		if (count == 2 && ratios[1] < ratios[0]) {
+			float swap = ratios[0];
+			ratios[0] = ratios[1];
+			ratios[1] = swap;
+		}
+
+		return count;
+	}
+
 	TOutput interpolate(TInput input, TInput const *inputs, TOutput const *outputs, size_t size) {
 		if (size == 0) return 0;
 		if (input <= inputs[0]) return outputs[0];
@@ -56,26 +150,7 @@ public:
 
 		for(size_t i = 0; i < size; ++i) {
 			if (inputs[i] <= input && input < inputs[i+1]) {
-				// First control point
-				TOutput c1 = (i > 0) ? outputs[i-1] : outputs[i];
-				// First point
-				TOutput v1 = outputs[i];
-				// Second point
-				TOutput v2 = (i < size - 1) ? outputs[i+1] : outputs[size-1];
-				// Second control point
-				TOutput c2 = (i < size - 2) ? outputs[i+2] : outputs[size-1];
-
-				float ratio = (input - inputs[i]) / (inputs[i+1] - inputs[i]);
-				return .5f * ((2.f * v1)
-					+ (v2 - c1) * ratio
-					+ (2.f * c1 - 5.f * v1 + 4.f * v2 - c2) * ratio * ratio
-					+ (3.f * v1 - c1 - 3.f * v2 + c2) * ratio * ratio * ratio);
-
-
-				////return c1 * ((-ratio + 2.f) * ratio - 1.f) * ratio * .5f
-				////	+ v1 * (((3.f * ratio - 5.f) * ratio) * ratio + 2.f) * .5f
-				////	+ v2 * ((-3.f * ratio + 4.f) * ratio + 1.f) * ratio * .5f
-				////	+ c2 * ((ratio - 1.f) * ratio * ratio) * .5f;
+				return interpolateSegment(input, i, inputs, outputs, size);
 			}
 		}
 
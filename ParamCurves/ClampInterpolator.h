@@ -46,6 +46,14 @@ public:
 		return &instance;
 	}
 
+	///
+	/// Calculate the output for an input inside the segment starting at index,
+	/// that is, inputs[index] <= input < inputs[index+1].
+	///
+	static TOutput interpolateSegment(TInput, size_t index, TInput const *, TOutput const *outputs, size_t) {
+		return outputs[index];
+	}
+
 	TOutput interpolate(TInput input, TInput const *inputs, TOutput const *outputs, size_t size) {
 		if (size == 0) return 0;
 		if (input <= inputs[0]) return outputs[0];
@@ -53,7 +61,7 @@ public:
 
 		for(size_t i = 0; i < size; ++i) {
 			if (inputs[i] <= input && input < inputs[i+1]) {
-				return outputs[i];
+				return interpolateSegment(input, i, inputs, outputs, size);
 			}
 		}
 
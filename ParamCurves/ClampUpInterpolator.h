@@ -46,14 +46,22 @@ public:
 		return &instance;
 	}
 
+	///
+	/// Calculate the output for an input inside the segment starting at index,
+	/// that is, inputs[index] <= input < inputs[index+1].
+	///
+	static TOutput interpolateSegment(TInput, size_t index, TInput const *, TOutput const *outputs, size_t) {
+		return outputs[index + 1];
+	}
+
 	TOutput interpolate(TInput input, TInput const *inputs, TOutput const *outputs, size_t size) {
 		if (size == 0) return 0;
 		if (input <= inputs[0]) return outputs[0];
-		if (inputs[size-2] <= input) return outputs[size-1];
+		if (size == 1 || inputs[size-2] <= input) return outputs[size-1];
 
 		for(size_t i = 0; i < size; ++i) {
 			if (inputs[i] <= input && input < inputs[i+1]) {
-				return outputs[i + 1];
+				return interpolateSegment(input, i, inputs, outputs, size);
 			}
 		}
 
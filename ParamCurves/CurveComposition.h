@@ -0,0 +1,675 @@
+///
+/// @file CurveComposition.h Composition and combination of curves into a single curve.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include <limits>
+#include "ParamCurve.h"
+#include "ClampInterpolator.h"
+#include "ClampUpInterpolator.h"
+#include "LinearInterpolator.h"
+#include "CatmullRomInterpolator.h"
+
+///
+/// Accumulates knots for a new curve, up to maxSize of them.
+/// @tparam TInput Input values type.
+/// @tparam TOutput Output values type.
+/// @tparam maxSize Maximum number of knots.
+///
+template<typename TInput, typename TOutput, size_t maxSize>
+class CurveBuilder {
+	size_t length;
+	bool overflow;
+	TInput inputs[maxSize];
+	TOutput outputs[maxSize];
+
+public:
+	CurveBuilder() : length(0), overflow(false) {}
+
+	///
+	/// Append a knot. Knots must be added in increasing input order.
+	/// @return false if there was no room left for the knot.
+	///
+	bool add(TInput const &input, TOutput const &output) {
+		if (length >= maxSize) {
+			overflow = true;
+			return false;
+		}
+
+		inputs[length] = input;
+		outputs[length] = output;
+		++length;
+		return true;
+	}
+
+	///
+	/// Initialize a curve with the knots added so far.
+	/// @param interpolator Interpolator for the new curve.
+	/// @param curve Curve to initialize. Left untouched if some knot did not fit.
+	/// @return true if the curve was initialized.
+	///
+	template<size_t curveSize>
+	bool build(Interpolator<TInput, TOutput>* interpolator, ParamCurve<TInput, TOutput, curveSize> &curve) {
+		if (overflow || length > curveSize) return false;
+
+		curve.initialize(interpolator, length, inputs, outputs);
+		return true;
+	}
+};
+
+///
+/// Position where approximateCurve starts an interval, with the values the
+/// approximated function approaches from both sides of it.
+///
+template<typename TInput, typename TOutput>
+struct ApproximationStart {
+	TInput input;
+	TOutput left;
+	TOutput right;
+	/// Whether left and right may differ, requiring a knot for each.
+	bool step;
+};
+
+///
+/// Obtain the values a curve approaches from both sides of an input. They may
+/// differ at duplicated inputs, and at any input of clamped curves. Curves
+/// using interpolators other than the built-in ones are taken as continuous.
+/// @param left Receives the value approached from lower inputs.
+/// @param right Receives the value approached from greater inputs.
+/// @return true if left and right may differ.
+///
+template<typename TInput, typename TOutput, size_t size>
+bool getCurveLimits(ParamCurve<TInput, TOutput, size> const &curve, TInput const &input, TOutput &left, TOutput &right) {
+	size_t length = curve.getLength();
+	size_t first = 0;
+	while (first < length && curve.getInput(first) < input) ++first;
+	size_t last = first;
+	while (last < length && !(input < curve.getInput(last))) ++last;
+
+	Interpolator<TInput, TOutput>* interpolator = curve.getInterpolator();
+	bool clamp = interpolator == ClampInterpolator<TInput, TOutput>::getInstance();
+	bool clampUp = interpolator == ClampUpInterpolator<TInput, TOutput>::getInstance();
+	bool builtIn = clamp || clampUp
+		|| interpolator == LinearInterpolator<TInput, TOutput>::getInstance()
+		|| interpolator == CatmullRomInterpolator<TInput, TOutput>::getInstance();
+	if (first == last || !builtIn) {
+		left = right = curve.getValue(input);
+		return false;
+	}
+
+	// Inputs from first to last (excluded) are equal to input.
+	size_t leftIndex = (clamp && first > 0) ? first - 1 : first;
+	size_t rightIndex = (clampUp && last < length) ? last : last - 1;
+	left = curve.getOutput(leftIndex);
+	right = curve.getOutput(rightIndex);
+	return leftIndex != rightIndex;
+}
+
+///
+/// Evaluates outer.getValue(inner.getValue(input)).
+///
+template<typename TInput, typename TMiddle, typename TOutput, size_t innerSize, size_t outerSize>
+struct CurveCompositionFunction {
+	ParamCurve<TInput, TMiddle, innerSize> const &inner;
+	ParamCurve<TMiddle, TOutput, outerSize> const &outer;
+
+	CurveCompositionFunction(ParamCurve<TInput, TMiddle, innerSize> const &newInner, ParamCurve<TMiddle, TOutput, outerSize> const &newOuter)
+		: inner(newInner), outer(newOuter) {}
+
+	TOutput operator()(TInput const &input) const {
+		return outer.getValue(inner.getValue(input));
+	}
+
+	///
+	/// Check whether inner crosses more than one outer input between left and right,
+	/// judging by the values of inner at both ends, so inner must be monotonic
+	/// in between.
+	///
+	bool spansBreaks(TInput const &left, TInput const &right) const {
+		TMiddle low = inner.getValue(left);
+		TMiddle high = inner.getValue(right);
+		if (high < low) {
+			TMiddle swap = low;
+			low = high;
+			high = swap;
+		}
+
+		size_t count = 0;
+		for(size_t k = 0; k < outer.getLength() && count < 2; ++k) {
+			if (low < outer.getInput(k) && outer.getInput(k) < high) ++count;
+		}
+
+		return count > 1;
+	}
+};
+
+///
+/// Evaluates the combination of two curves through a binary operation.
+///
+template<typename TInput, typename TOutput, size_t sizeA, size_t sizeB, typename TOperation>
+struct CurveCombinationFunction {
+	ParamCurve<TInput, TOutput, sizeA> const &a;
+	ParamCurve<TInput, TOutput, sizeB> const &b;
+	TOperation operation;
+
+	CurveCombinationFunction(ParamCurve<TInput, TOutput, sizeA> const &newA, ParamCurve<TInput, TOutput, sizeB> const &newB, TOperation const &newOperation)
+		: a(newA), b(newB), operation(newOperation) {}
+
+	TOutput operator()(TInput const &input) const {
+		return operation(a.getValue(input), b.getValue(input));
+	}
+
+	///
+	/// Check whether there is more than one input of a or b between left and right.
+	///
+	bool spansBreaks(TInput const &left, TInput const &right) const {
+		size_t count = 0;
+		for(size_t k = 0; k < a.getLength() && count < 2; ++k) {
+			if (left < a.getInput(k) && a.getInput(k) < right) ++count;
+		}
+		for(size_t k = 0; k < b.getLength() && count < 2; ++k) {
+			if (left < b.getInput(k) && b.getInput(k) < right) ++count;
+		}
+
+		return count > 1;
+	}
+};
+
+///
+/// Adds two output values.
+///
+template<typename TOutput>
+struct CurveSum {
+	TOutput operator()(TOutput const &a, TOutput const &b) const {
+		return a + b;
+	}
+};
+
+///
+/// Blends two output values: a * (1 - weight) + b * weight.
+///
+template<typename TOutput>
+struct CurveBlend {
+	float weight;
+
+	CurveBlend(float newWeight) : weight(newWeight) {}
+
+	TOutput operator()(TOutput const &a, TOutput const &b) const {
+		return a * (1.f - weight) + b * weight;
+	}
+};
+
+///
+/// Adds to builder a linear approximation of function between left and right,
+/// excluding the knot at left, which must have been added already.
+/// leftValue and rightValue are the values function approaches inside the
+/// interval at its ends. Intervals are halved until the approximation is within
+/// half the tolerance at each eighth of their length (leaving margin for the
+/// error between those points) and they span at most one break of the function.
+/// Checking a single break in between keeps regular breaks (such as
+/// alternating outputs) from landing all on the checked points.
+/// @return false if depth ran out before that, or builder ran out of room.
+///
+template<typename TInput, typename TOutput, size_t maxSize, typename TFunction>
+bool approximateInterval(TFunction const &function, TInput const &left, TOutput const &leftValue,
+	TInput const &right, TOutput const &rightValue, float tolerance, int depth,
+	CurveBuilder<TInput, TOutput, maxSize> &builder) {
+	// Nothing to approximate without inputs inside (as between consecutive integers)
+	TInput middle = InterpolationRatio<TInput>::getInput(.5f, left, right);
+	if (!(left < middle && middle < right)) return builder.add(right, rightValue);
+
+	float margin = tolerance * .5f;
+	bool accurate = !function.spansBreaks(left, right);
+	for(int eighth = 1; eighth <= 7 && accurate; ++eighth) {
+		TInput input = InterpolationRatio<TInput>::getInput(eighth * .125f, left, right);
+		float ratio = (float)InterpolationRatio<TInput>::get(input, left, right);
+		TOutput expected = leftValue + ((rightValue - leftValue) * ratio);
+		float error = (float)(function(input) - expected);
+		accurate = -margin <= error && error <= margin;
+	}
+
+	if (!accurate) {
+		if (depth == 0) return false;
+
+		TOutput middleValue = function(middle);
+		return approximateInterval(function, left, leftValue, middle, middleValue, tolerance, depth - 1, builder)
+			&& approximateInterval(function, middle, middleValue, right, rightValue, tolerance, depth - 1, builder);
+	}
+
+	return builder.add(right, rightValue);
+}
+
+///
+/// Builds a linear curve approximating function, with knots at each of the
+/// received (sorted) starts plus as many as needed in between to stay within
+/// tolerance. Starts sharing their input add a knot with their right value.
+/// @return true if result was initialized; false if some interval did not get
+/// within tolerance in 16 halvings, or the result needs more than resultSize knots.
+///
+template<typename TInput, typename TOutput, size_t resultSize, typename TFunction>
+bool approximateCurve(TFunction const &function, ApproximationStart<TInput, TOutput> const *starts, size_t startCount,
+	float tolerance, ParamCurve<TInput, TOutput, resultSize> &result) {
+	const int maxDepth = 16;
+	CurveBuilder<TInput, TOutput, resultSize> builder;
+
+	if (startCount == 0) return false;
+
+	if (!builder.add(starts[0].input, starts[0].left)) return false;
+	if (starts[0].step && !builder.add(starts[0].input, starts[0].right)) return false;
+
+	for(size_t i = 1; i < startCount; ++i) {
+		ApproximationStart<TInput, TOutput> const &previous = starts[i - 1];
+		ApproximationStart<TInput, TOutput> const &start = starts[i];
+		if (!(previous.input < start.input)) {
+			if (!builder.add(start.input, start.right)) return false;
+			continue;
+		}
+
+		if (!approximateInterval(function, previous.input, previous.right, start.input, start.left, tolerance, maxDepth, builder)) return false;
+		if (start.step && !builder.add(start.input, start.right)) return false;
+	}
+
+	return builder.build(LinearInterpolator<TInput, TOutput>::getInstance(), result);
+}
+
+///
+/// Find where the segment of a linear inner curve starting at index crosses
+/// the inputs of outer strictly between the outputs at its ends, in increasing
+/// input order. Duplicated outer inputs are crossed once.
+/// @param positions Receives the inputs of inner at the crossings.
+/// Requires room for outer.getLength() elements.
+/// @param knots Receives the positions in outer of the inputs crossed.
+/// Requires room for outer.getLength() elements.
+/// @param increasing Receives whether the segment is increasing.
+/// @return Number of crossings.
+///
+template<typename TInput, typename TMiddle, typename TOutput, size_t innerSize, size_t outerSize>
+size_t findCrossings(ParamCurve<TInput, TMiddle, innerSize> const &inner, size_t index,
+	ParamCurve<TMiddle, TOutput, outerSize> const &outer, TInput *positions, size_t *knots, bool &increasing) {
+	size_t outerLength = outer.getLength();
+	TInput const &x1 = inner.getInput(index);
+	TMiddle const &y1 = inner.getOutput(index);
+	TInput const &x2 = inner.getInput(index + 1);
+	TMiddle const &y2 = inner.getOutput(index + 1);
+
+	increasing = y1 < y2;
+	if (!(x1 < x2) || (!increasing && !(y2 < y1))) return 0;
+
+	size_t count = 0;
+	for(size_t j = 0; j < outerLength; ++j) {
+		size_t k = increasing ? j : outerLength - 1 - j;
+		TMiddle const &u = outer.getInput(k);
+		if (increasing ? !(y1 < u && u < y2) : !(y2 < u && u < y1)) continue;
+		if (count > 0 && !(u < outer.getInput(knots[count - 1])) && !(outer.getInput(knots[count - 1]) < u)) continue;
+
+		float ratio = (float)InterpolationRatio<TMiddle>::get(u, y1, y2);
+		TInput x = InterpolationRatio<TInput>::getInput(ratio, x1, x2);
+		if (x2 < x) x = x2;
+
+		positions[count] = x;
+		knots[count] = k;
+		++count;
+	}
+
+	return count;
+}
+
+///
+/// Obtain the value of outer approached by inner at one side of a knot or
+/// crossing, from the direction inner moves to or from there.
+/// @param direction Negative if inner is below output at that side, positive
+/// if above, 0 if inner stays at output.
+///
+template<typename TMiddle, typename TOutput, size_t outerSize>
+TOutput getCompositionSide(ParamCurve<TMiddle, TOutput, outerSize> const &outer, TMiddle const &output,
+	int direction, TOutput const &left, TOutput const &right) {
+	if (direction < 0) return left;
+	if (direction > 0) return right;
+	return outer.getValue(output);
+}
+
+///
+/// Check whether value comes before u, moving in the given direction.
+///
+template<typename TMiddle>
+bool isBefore(TMiddle const &value, TMiddle const &u, bool increasing) {
+	return increasing ? value < u : u < value;
+}
+
+///
+/// Obtain the value of the linear segment of inner starting at index, up to
+/// its end (where inner may take another value, if its input is duplicated).
+///
+template<typename TInput, typename TMiddle, size_t innerSize>
+TMiddle getSegmentValue(ParamCurve<TInput, TMiddle, innerSize> const &inner, size_t index, TInput const &input) {
+	return LinearInterpolator<TInput, TMiddle>::interpolateSegment(input, index, &inner.getInput(0), &inner.getOutput(0), inner.getLength());
+}
+
+///
+/// Add a start with the value of function at input, unless the last start is
+/// already there.
+///
+template<typename TInput, typename TOutput, typename TFunction>
+void addValueStart(TFunction const &function, TInput const &input, ApproximationStart<TInput, TOutput> *starts, size_t &count) {
+	if (count > 0 && !(starts[count - 1].input < input)) return;
+
+	ApproximationStart<TInput, TOutput> &start = starts[count++];
+	start.input = input;
+	start.left = start.right = function(input);
+	start.step = false;
+}
+
+///
+/// Find the starts of the composition with a linear inner curve: at inner knots,
+/// and where inner crosses outer inputs. Their values come from the side
+/// of outer inner arrives from and leaves to, so that steps of outer at those
+/// points are kept, and the composition is linear (or constant) in between when
+/// outer is linear (or clamped).
+/// Integer inputs cannot hold the crossings, so the starts are the integers at
+/// both sides of them instead, with their values, which is all integer inputs
+/// can reach.
+/// @param starts Receives the starts. Requires room for maxStarts elements.
+/// @return Number of starts; maxStarts + 1 if they did not fit.
+///
+template<typename TInput, typename TMiddle, typename TOutput, size_t innerSize, size_t outerSize>
+size_t findLinearCompositionStarts(ParamCurve<TInput, TMiddle, innerSize> const &inner, ParamCurve<TMiddle, TOutput, outerSize> const &outer,
+	ApproximationStart<TInput, TOutput> *starts, size_t maxStarts) {
+	CurveCompositionFunction<TInput, TMiddle, TOutput, innerSize, outerSize> function(inner, outer);
+	bool integer = std::numeric_limits<TInput>::is_integer;
+	size_t innerLength = inner.getLength();
+	TInput positions[outerSize];
+	size_t knots[outerSize];
+	size_t count = 0;
+	for(size_t i = 0; i < innerLength; ++i) {
+		if (count + (integer ? 3 : 1) > maxStarts) return maxStarts + 1;
+
+		if (integer) {
+			// At duplicated inputs, and on steps of outer, the value at the knot
+			// may be isolated: keep the integers next to it
+			TInput const &x = inner.getInput(i);
+			TOutput left, right;
+			bool step = getCurveLimits(outer, inner.getOutput(i), left, right)
+				|| (i > 0 && !(inner.getInput(i - 1) < x)) || (i + 1 < innerLength && !(x < inner.getInput(i + 1)));
+			if (step && inner.getInput(0) < x) addValueStart(function, TInput(x - 1), starts, count);
+			addValueStart(function, x, starts, count);
+			bool next = (i + 1 < innerLength) ? x < inner.getInput(i + 1) && TInput(x + 1) < inner.getInput(i + 1) : x < std::numeric_limits<TInput>::max();
+			if (step && next) addValueStart(function, TInput(x + 1), starts, count);
+		}
+		else {
+			TMiddle const &y = inner.getOutput(i);
+			int arrival = 0;
+			if (i > 0) arrival = (inner.getOutput(i - 1) < y) ? -1 : (y < inner.getOutput(i - 1)) ? 1 : 0;
+			int departure = 0;
+			if (i + 1 < innerLength) departure = (y < inner.getOutput(i + 1)) ? 1 : (inner.getOutput(i + 1) < y) ? -1 : 0;
+
+			TOutput left, right;
+			bool step = getCurveLimits(outer, y, left, right);
+			ApproximationStart<TInput, TOutput> &start = starts[count++];
+			start.input = inner.getInput(i);
+			start.left = getCompositionSide(outer, y, arrival, left, right);
+			start.right = getCompositionSide(outer, y, departure, left, right);
+			start.step = step && arrival != departure;
+		}
+		if (i + 1 == innerLength) continue;
+
+		bool increasing;
+		size_t crossings = findCrossings(inner, i, outer, positions, knots, increasing);
+		for(size_t c = 0; c < crossings; ++c) {
+			if (count + (integer ? 3 : 1) > maxStarts) return maxStarts + 1;
+
+			if (integer) {
+				// Positions are rounded down from the crossings, to the precision
+				// of TMiddle: settle on the last integer before the crossing
+				TInput x = positions[c];
+				TMiddle const &u = outer.getInput(knots[c]);
+				while (inner.getInput(i) < x && !isBefore(getSegmentValue(inner, i, x), u, increasing)) x = TInput(x - 1);
+				while (x < inner.getInput(i + 1) && TInput(x + 1) < inner.getInput(i + 1) && isBefore(getSegmentValue(inner, i, TInput(x + 1)), u, increasing)) x = TInput(x + 1);
+				addValueStart(function, x, starts, count);
+
+				// An integer on the crossing has an isolated value, keep the one after it too
+				for(int k = 0; k < 2 && x < inner.getInput(i + 1); ++k) {
+					x = TInput(x + 1);
+					addValueStart(function, x, starts, count);
+					if (isBefore(u, getSegmentValue(inner, i, x), increasing)) break;
+				}
+				continue;
+			}
+
+			TOutput left, right;
+			ApproximationStart<TInput, TOutput> &crossing = starts[count++];
+			crossing.input = positions[c];
+			crossing.step = getCurveLimits(outer, outer.getInput(knots[c]), left, right);
+			crossing.left = increasing ? left : right;
+			crossing.right = increasing ? right : left;
+		}
+	}
+
+	return count;
+}
+
+///
+/// Builds a single curve returning outer.getValue(inner.getValue(input)).
+/// The result is exact, except for the value at isolated discontinuities, when
+/// inner uses clamp interpolation, or inner uses linear interpolation and outer
+/// clamp or linear interpolation. Otherwise it is a linear curve within
+/// tolerance, sampled between inner knots, the points where a linear inner
+/// crosses outer inputs, and the extrema of a Catmull-Rom inner. Tolerance is
+/// only guaranteed when inner is monotonic between those points, which
+/// interpolators other than the built-in ones need not be. With integer
+/// inputs, knots go to the integers around crossings, so the result matches
+/// at integers only.
+/// @tparam TInput Input values type. Required operators:
+/// TInput operator<(TInput&)
+/// TInput operator+(TInput&)
+/// TInput operator-(TInput&)
+/// TInput operator*(float&)
+/// @tparam TMiddle Output type of inner and input type of outer. Required operators:
+/// TMiddle operator<(TMiddle&)
+/// TMiddle operator-(TMiddle&)
+/// TMiddle operator/(TMiddle&), convertible to float.
+/// @tparam TOutput Output values type. Required operators:
+/// TOutput operator+(TOutput&)
+/// TOutput operator-(TOutput&)
+/// TOutput operator*(float&), convertible to float.
+/// @param outer Curve applied last.
+/// @param inner Curve applied first.
+/// @param tolerance Maximum error allowed when the result has to be sampled.
+/// @param result Curve to initialize with the composition.
+/// @return true if result was initialized; false if some curve was empty,
+/// the result needs more than resultSize knots, or sampling did not get within
+/// tolerance (as around steps of outer that inner reaches between knots).
+///
+template<typename TInput, typename TMiddle, typename TOutput, size_t innerSize, size_t outerSize, size_t resultSize>
+bool composeCurves(ParamCurve<TMiddle, TOutput, outerSize> const &outer, ParamCurve<TInput, TMiddle, innerSize> const &inner,
+	float tolerance, ParamCurve<TInput, TOutput, resultSize> &result) {
+	size_t innerLength = inner.getLength();
+	size_t outerLength = outer.getLength();
+	if (innerLength == 0 || outerLength == 0) return false;
+
+	// Built-in interpolators are told by their instance, as others need not set their mode.
+	bool innerClamp = inner.getInterpolator() == ClampInterpolator<TInput, TMiddle>::getInstance();
+	bool innerLinear = inner.getInterpolator() == LinearInterpolator<TInput, TMiddle>::getInstance();
+	bool innerCatmullRom = inner.getInterpolator() == CatmullRomInterpolator<TInput, TMiddle>::getInstance();
+	bool outerClamp = outer.getInterpolator() == ClampInterpolator<TMiddle, TOutput>::getInstance();
+	bool outerLinear = outer.getInterpolator() == LinearInterpolator<TMiddle, TOutput>::getInstance();
+	CurveBuilder<TInput, TOutput, resultSize> builder;
+
+	if (innerClamp) {
+		// Inner is a step function, so is the composition.
+		for(size_t i = 0; i < innerLength; ++i) {
+			builder.add(inner.getInput(i), outer.getValue(inner.getOutput(i)));
+		}
+
+		return builder.build(ClampInterpolator<TInput, TOutput>::getInstance(), result);
+	}
+
+	ApproximationStart<TInput, TOutput> starts[resultSize];
+	size_t startCount = 0;
+	if (innerLinear) {
+		startCount = findLinearCompositionStarts(inner, outer, starts, resultSize);
+		if (startCount > resultSize) return false;
+	}
+
+	if (innerLinear && (outerLinear || outerClamp)) {
+		// Piecewise linear (or constant) between the starts.
+		for(size_t i = 0; i < startCount; ++i) {
+			builder.add(starts[i].input, starts[i].left);
+			if (starts[i].step) builder.add(starts[i].input, starts[i].right);
+		}
+
+		if (outerClamp) {
+			return builder.build(ClampInterpolator<TInput, TOutput>::getInstance(), result);
+		}
+
+		return builder.build(LinearInterpolator<TInput, TOutput>::getInstance(), result);
+	}
+
+	CurveCompositionFunction<TInput, TMiddle, TOutput, innerSize, outerSize> function(inner, outer);
+	if (!innerLinear) {
+		// Inner knots, plus the extrema of Catmull-Rom segments, so that inner
+		// is monotonic between starts.
+		for(size_t i = 0; i < innerLength; ++i) {
+			if (startCount == resultSize) return false;
+
+			TInput const &x1 = inner.getInput(i);
+			TMiddle left, right;
+			ApproximationStart<TInput, TOutput> &start = starts[startCount++];
+			start.input = x1;
+			start.step = getCurveLimits(inner, x1, left, right);
+			start.left = outer.getValue(left);
+			start.right = outer.getValue(right);
+			if (!innerCatmullRom || i + 1 == innerLength || !(x1 < inner.getInput(i + 1))) continue;
+
+			float ratios[2];
+			size_t count = CatmullRomInterpolator<TInput, TMiddle>::findExtrema(i, &inner.getOutput(0), innerLength, ratios);
+			for(size_t r = 0; r < count; ++r) {
+				if (startCount == resultSize) return false;
+
+				ApproximationStart<TInput, TOutput> &extremum = starts[startCount++];
+				extremum.input = InterpolationRatio<TInput>::getInput(ratios[r], x1, inner.getInput(i + 1));
+				extremum.left = extremum.right = function(extremum.input);
+				extremum.step = false;
+			}
+		}
+	}
+
+	return approximateCurve(function, starts, startCount, tolerance, result);
+}
+
+///
+/// Builds a single curve returning operation(a.getValue(input), b.getValue(input)).
+/// The result is exact when both curves use linear interpolation, or both use
+/// clamp interpolation. Otherwise it is a linear curve within tolerance, sampled
+/// between the knots of both curves, keeping the steps at those knots.
+/// See composeCurves for type requirements.
+/// @param a First curve.
+/// @param b Second curve.
+/// @param operation Function object combining two output values.
+/// @param tolerance Maximum error allowed when the result has to be sampled.
+/// @param result Curve to initialize with the combination.
+/// @return true if result was initialized; false if some curve was empty,
+/// the result needs more than resultSize knots, or sampling did not get within
+/// tolerance.
+///
+template<typename TInput, typename TOutput, size_t sizeA, size_t sizeB, size_t resultSize, typename TOperation>
+bool combineCurves(ParamCurve<TInput, TOutput, sizeA> const &a, ParamCurve<TInput, TOutput, sizeB> const &b,
+	TOperation const &operation, float tolerance, ParamCurve<TInput, TOutput, resultSize> &result) {
+	size_t lengthA = a.getLength();
+	size_t lengthB = b.getLength();
+	if (lengthA == 0 || lengthB == 0) return false;
+
+	Interpolator<TInput, TOutput>* linearInstance = LinearInterpolator<TInput, TOutput>::getInstance();
+	Interpolator<TInput, TOutput>* clampInstance = ClampInterpolator<TInput, TOutput>::getInstance();
+	bool linear = a.getInterpolator() == linearInstance && b.getInterpolator() == linearInstance;
+	bool clamp = a.getInterpolator() == clampInstance && b.getInterpolator() == clampInstance;
+
+	// Merge knot positions of both curves.
+	CurveBuilder<TInput, TOutput, resultSize> builder;
+	ApproximationStart<TInput, TOutput> starts[sizeA + sizeB];
+	size_t startCount = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < lengthA || j < lengthB) {
+		TInput x = (j == lengthB || (i < lengthA && a.getInput(i) <= b.getInput(j))) ? a.getInput(i) : b.getInput(j);
+		size_t firstA = i;
+		size_t firstB = j;
+		while (i < lengthA && !(x < a.getInput(i))) ++i;
+		while (j < lengthB && !(x < b.getInput(j))) ++j;
+
+		if (linear) {
+			// Duplicated knots are discontinuities: keep the values at both sides.
+			TOutput leftA = (firstA < i) ? a.getOutput(firstA) : a.getValue(x);
+			TOutput leftB = (firstB < j) ? b.getOutput(firstB) : b.getValue(x);
+			builder.add(x, operation(leftA, leftB));
+			if (i - firstA > 1 || j - firstB > 1) {
+				builder.add(x, operation((firstA < i) ? a.getOutput(i - 1) : leftA, (firstB < j) ? b.getOutput(j - 1) : leftB));
+			}
+		}
+		else if (clamp) {
+			// Duplicated knots are steps: keep the value after them, and the
+			// value before them too for the first knot.
+			TOutput rightA = (firstA < i) ? a.getOutput(i - 1) : a.getValue(x);
+			TOutput rightB = (firstB < j) ? b.getOutput(j - 1) : b.getValue(x);
+			if (firstA + firstB == 0 && (i > 1 || j > 1)) builder.add(x, operation(a.getValue(x), b.getValue(x)));
+			builder.add(x, operation(rightA, rightB));
+		}
+		else {
+			TOutput leftA, rightA, leftB, rightB;
+			ApproximationStart<TInput, TOutput> &start = starts[startCount++];
+			start.input = x;
+			start.step = getCurveLimits(a, x, leftA, rightA);
+			start.step = getCurveLimits(b, x, leftB, rightB) || start.step;
+			start.left = operation(leftA, leftB);
+			start.right = operation(rightA, rightB);
+		}
+	}
+
+	if (linear) return builder.build(LinearInterpolator<TInput, TOutput>::getInstance(), result);
+	if (clamp) return builder.build(ClampInterpolator<TInput, TOutput>::getInstance(), result);
+
+	CurveCombinationFunction<TInput, TOutput, sizeA, sizeB, TOperation> function(a, b, operation);
+	return approximateCurve(function, starts, startCount, tolerance, result);
+}
+
+///
+/// Builds a single curve returning a.getValue(input) + b.getValue(input).
+/// See combineCurves.
+///
+template<typename TInput, typename TOutput, size_t sizeA, size_t sizeB, size_t resultSize>
+bool sumCurves(ParamCurve<TInput, TOutput, sizeA> const &a, ParamCurve<TInput, TOutput, sizeB> const &b,
+	float tolerance, ParamCurve<TInput, TOutput, resultSize> &result) {
+	return combineCurves(a, b, CurveSum<TOutput>(), tolerance, result);
+}
+
+///
+/// Builds a single curve returning a.getValue(input) * (1 - weight) + b.getValue(input) * weight.
+/// See combineCurves.
+///
+template<typename TInput, typename TOutput, size_t sizeA, size_t sizeB, size_t resultSize>
+bool blendCurves(ParamCurve<TInput, TOutput, sizeA> const &a, ParamCurve<TInput, TOutput, sizeB> const &b,
+	float weight, float tolerance, ParamCurve<TInput, TOutput, resultSize> &result) {
+	return combineCurves(a, b, CurveBlend<TOutput>(weight), tolerance, result);
+}
@@ -0,0 +1,267 @@
+///
+/// @file CurveExtrema.h Minimum and maximum of a curve over input intervals.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include "ParamCurve.h"
+#include "ClampInterpolator.h"
+#include "ClampUpInterpolator.h"
+#include "LinearInterpolator.h"
+#include "CatmullRomInterpolator.h"
+
+///
+/// Answers minimum and maximum output queries over input intervals of a curve
+/// in O(log n), using a segment tree of the extrema of each curve segment.
+/// Extrema of Catmull-Rom segments come from the roots of the derivative of
+/// their cubic. At discontinuities (duplicated inputs) one-sided limits count
+/// as reached. The tree is built on initialize, and built again on the next
+/// query if the curve was initialized again in between. Only curves using
+/// the built-in interpolators are supported.
+/// @tparam TInput Input values type. Required operators:
+/// TInput operator<=(TInput&)
+/// TInput operator<(TInput&)
+/// TInput operator-(TInput&)
+/// TInput operator/(TInput&)
+/// @tparam TOutput Output values type. Required operators:
+/// bool operator<(TOutput&), plus those required by the curve interpolator.
+/// Catmull-Rom curves also require TOutput to be convertible to float.
+/// @tparam maxSize Maximum size of the curve.
+///
+template<typename TInput, typename TOutput, size_t maxSize>
+class CurveExtrema {
+	ParamCurve<TInput, TOutput, maxSize> const *curve;
+	unsigned long long version;
+	t_interpolationMode mode;
+	bool supported;
+	size_t segments;
+	TOutput minimums[2 * maxSize];
+	TOutput maximums[2 * maxSize];
+
+	static void include(TOutput const &value, TOutput &minimum, TOutput &maximum) {
+		if (value < minimum) minimum = value;
+		if (maximum < value) maximum = value;
+	}
+
+	///
+	/// Find the mode of a built-in interpolator by its instance, as other
+	/// interpolators need not set their mode.
+	/// @return false if the interpolator is not a built-in one.
+	///
+	static bool findMode(Interpolator<TInput, TOutput>* interpolator, t_interpolationMode &mode) {
+		if (interpolator == ClampInterpolator<TInput, TOutput>::getInstance()) mode = interpolationClamp;
+		else if (interpolator == ClampUpInterpolator<TInput, TOutput>::getInstance()) mode = interpolationClampUp;
+		else if (interpolator == LinearInterpolator<TInput, TOutput>::getInstance()) mode = interpolationLinear;
+		else if (interpolator == CatmullRomInterpolator<TInput, TOutput>::getInstance()) mode = interpolationCatmullRom;
+		else return false;
+
+		return true;
+	}
+
+	float getRatio(TInput const &input, size_t index) const {
+		return (float)InterpolationRatio<TInput>::get(input, curve->getInput(index), curve->getInput(index + 1));
+	}
+
+	///
+	/// Include the extrema of the segment starting at index, between two ratios.
+	/// Values at ratios other than 0 and 1 are expected to be included by the caller.
+	///
+	void includeSegment(size_t index, float from, float to, TOutput &minimum, TOutput &maximum) const {
+		TOutput const *outputs = &curve->getOutput(0);
+		size_t length = curve->getLength();
+
+		switch(mode) {
+		case interpolationClamp:
+			include(outputs[index], minimum, maximum);
+			break;
+
+		case interpolationClampUp:
+			include(outputs[index + 1], minimum, maximum);
+			break;
+
+		case interpolationCatmullRom:
+			// Extrema inside the segment, then the values at its ends as for the other modes
+			if (curve->getInput(index) < curve->getInput(index + 1)) {
+				float ratios[2];
+				size_t count = CatmullRomInterpolator<TInput, TOutput>::findExtrema(index, outputs, length, ratios);
+				for(size_t i = 0; i < count; ++i) {
+					if (from < ratios[i] && ratios[i] < to) {
+						include(CatmullRomInterpolator<TInput, TOutput>::interpolateRatio(ratios[i], index, outputs, length), minimum, maximum);
+					}
+				}
+			}
+			// fall through
+		default:
+			if (from == 0.f) include(outputs[index], minimum, maximum);
+			if (to == 1.f) include(outputs[index + 1], minimum, maximum);
+			break;
+		}
+	}
+
+	///
+	/// Find the first input not lower than value.
+	///
+	size_t lowerBound(TInput const &value) const {
+		size_t first = 0;
+		size_t last = curve->getLength();
+		while (first < last) {
+			size_t middle = first + (last - first) / 2;
+			if (curve->getInput(middle) < value) first = middle + 1;
+			else last = middle;
+		}
+
+		return first;
+	}
+
+	///
+	/// Find the first input greater than value.
+	///
+	size_t upperBound(TInput const &value) const {
+		size_t first = 0;
+		size_t last = curve->getLength();
+		while (first < last) {
+			size_t middle = first + (last - first) / 2;
+			if (value < curve->getInput(middle)) last = middle;
+			else first = middle + 1;
+		}
+
+		return first;
+	}
+
+	void build() {
+		size_t length = curve->getLength();
+		version = curve->getVersion();
+		supported = findMode(curve->getInterpolator(), mode);
+		segments = (length > 1 && supported) ? length - 1 : 0;
+		if (segments == 0) return;
+
+		for(size_t i = 0; i < segments; ++i) {
+			TOutput &minimum = minimums[segments + i];
+			TOutput &maximum = maximums[segments + i];
+			if (curve->getInput(i) < curve->getInput(i + 1)) {
+				minimum = maximum = (mode == interpolationClampUp) ? curve->getOutput(i + 1) : curve->getOutput(i);
+				includeSegment(i, 0.f, 1.f, minimum, maximum);
+			}
+			else {
+				// Empty segment: only the value at its input is reached.
+				minimum = maximum = curve->getValue(curve->getInput(i));
+			}
+		}
+
+		for(size_t node = segments - 1; node > 0; --node) {
+			minimums[node] = minimums[2 * node];
+			maximums[node] = maximums[2 * node];
+			include(minimums[2 * node + 1], minimums[node], maximums[node]);
+			include(maximums[2 * node + 1], minimums[node], maximums[node]);
+		}
+	}
+
+	///
+	/// Include the extrema of the segments from first to last, both included.
+	///
+	void includeSegments(size_t first, size_t last, TOutput &minimum, TOutput &maximum) const {
+		size_t left = first + segments;
+		size_t right = last + segments + 1;
+		for(; left < right; left /= 2, right /= 2) {
+			if (left & 1) {
+				include(minimums[left], minimum, maximum);
+				include(maximums[left], minimum, maximum);
+				++left;
+			}
+			if (right & 1) {
+				--right;
+				include(minimums[right], minimum, maximum);
+				include(maximums[right], minimum, maximum);
+			}
+		}
+	}
+
+public:
+	///
+	/// Creates a new instance of CurveExtrema, not attached to any curve.
+	///
+	CurveExtrema() : curve(0), version(0), mode(interpolationLinear), supported(false), segments(0) {}
+
+	///
+	/// Attach to a curve and build the extrema of its segments.
+	/// @param newCurve Curve to answer queries about. Must outlive this instance.
+	///
+	void initialize(ParamCurve<TInput, TOutput, maxSize> const &newCurve) {
+		curve = &newCurve;
+		build();
+	}
+
+	///
+	/// Obtain the minimum and maximum values of the curve over an input interval.
+	/// @param left First input of the interval.
+	/// @param right Last input of the interval (included).
+	/// @param minimum Receives the minimum output.
+	/// @param maximum Receives the maximum output.
+	/// @return false if the curve is empty, not initialized, or uses an
+	/// interpolator other than the built-in ones.
+	///
+	bool getExtrema(TInput left, TInput right, TOutput &minimum, TOutput &maximum) {
+		if (curve == 0 || curve->getLength() == 0) return false;
+		if (version != curve->getVersion()) build();
+		if (!supported) return false;
+		if (right < left) {
+			TInput swap = left;
+			left = right;
+			right = swap;
+		}
+
+		minimum = maximum = curve->getValue(left);
+		include(curve->getValue(right), minimum, maximum);
+
+		size_t length = curve->getLength();
+		size_t first = lowerBound(left);
+		size_t last = upperBound(right);
+
+		if (first == last) {
+			// No input inside the interval: both ends lie in the same segment, if any.
+			if (first > 0 && first < length) {
+				includeSegment(first - 1, getRatio(left, first - 1), getRatio(right, first - 1), minimum, maximum);
+			}
+			return true;
+		}
+
+		// Segment containing left, ending inside the interval
+		if (first > 0 && first < length && left < curve->getInput(first)) {
+			includeSegment(first - 1, getRatio(left, first - 1), 1.f, minimum, maximum);
+		}
+
+		// Segments completely inside the interval
+		if (first + 1 < last) {
+			includeSegments(first, last - 2, minimum, maximum);
+		}
+
+		// Segment containing right, starting inside the interval
+		if (last > 0 && last < length && curve->getInput(last - 1) < right) {
+			includeSegment(last - 1, 0.f, getRatio(right, last - 1), minimum, maximum);
+		}
+
+		return true;
+	}
+};
@@ -0,0 +1,271 @@
+///
+/// @file CurveLoader.h Validation and initialization of many curves on worker threads.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ParamCurve.h"
+
+enum t_loadStatus {
+	loadPending
+	, loadRunning
+	, loadReady
+	, loadInvalidLength
+	, loadUnsorted
+	, loadNoInterpolator
+};
+
+///
+/// Optional last stage of a load, run on the same thread right after the curve
+/// is initialized, to build data derived from the curve (CurveExtrema,
+/// lookup tables, composed curves...).
+///
+template<typename TInput, typename TOutput, size_t maxSize>
+class CurveBaker {
+public:
+	virtual ~CurveBaker() {}
+
+	///
+	/// Called once per curve loaded with this baker. May be called from
+	/// several threads at the same time, for different curves.
+	/// @param curve The curve, already initialized.
+	/// @param handle Handle returned by CurveLoader::load for the curve.
+	///
+	virtual void bake(ParamCurve<TInput, TOutput, maxSize> const &curve, size_t handle) = 0;
+};
+
+///
+/// Validates, initializes and optionally bakes curves on a pool of worker
+/// threads. Each curve is published as soon as it is ready, so startup only
+/// needs to wait for the curves it uses first; waiting for a curve no worker
+/// has started loads it right away on the calling thread.
+/// The target curves must not be accessed until their load is finished
+/// (wait returned, or getStatus returned a status other than pending or running),
+/// and must outlive the loader.
+/// Requires C++11.
+/// @tparam TInput Input values type. Required operators:
+/// TInput operator<=(TInput&)
+/// @tparam TOutput Output values type.
+/// @tparam maxSize Maximum size of the curves.
+///
+template<typename TInput, typename TOutput, size_t maxSize>
+class CurveLoader {
+	struct Job {
+		ParamCurve<TInput, TOutput, maxSize>* curve;
+		Interpolator<TInput, TOutput>* interpolator;
+		std::vector<TInput> inputs;
+		std::vector<TOutput> outputs;
+		CurveBaker<TInput, TOutput, maxSize>* baker;
+		std::atomic<int> status;
+	};
+
+	std::deque<Job> jobs;
+	std::deque<size_t> queue;
+	std::vector<std::thread> workers;
+	mutable std::mutex mutex;
+	std::condition_variable queued;
+	std::condition_variable finished;
+	bool stopping;
+
+	CurveLoader(CurveLoader const &);
+	CurveLoader &operator=(CurveLoader const &);
+
+	// Jobs are never removed, and deque::emplace_back keeps references valid,
+	// so jobs can be used out of the lock once found.
+	Job &getJob(size_t handle) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return jobs[handle];
+	}
+
+	Job const &getJob(size_t handle) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return jobs[handle];
+	}
+
+	///
+	/// Check the knots can make a valid curve.
+	///
+	static t_loadStatus validate(Job const &job) {
+		size_t length = job.inputs.size();
+		if (job.interpolator == 0) return loadNoInterpolator;
+		if (length > maxSize) return loadInvalidLength;
+
+		for(size_t i = 1; i < length; ++i) {
+			if (!(job.inputs[i - 1] <= job.inputs[i])) return loadUnsorted;
+		}
+
+		return loadReady;
+	}
+
+	///
+	/// Run all the stages of a job, unless some other thread already started it.
+	///
+	void run(size_t handle) {
+		Job &job = getJob(handle);
+		int expected = loadPending;
+		if (!job.status.compare_exchange_strong(expected, loadRunning)) return;
+
+		t_loadStatus status = validate(job);
+		if (status == loadReady) {
+			size_t length = job.inputs.size();
+			job.curve->initialize(job.interpolator, length,
+				length ? &job.inputs[0] : 0, length ? &job.outputs[0] : 0);
+			if (job.baker) job.baker->bake(*job.curve, handle);
+		}
+
+		// Knots are in the curve now
+		std::vector<TInput>().swap(job.inputs);
+		std::vector<TOutput>().swap(job.outputs);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job.status.store(status, std::memory_order_release);
+		}
+		finished.notify_all();
+	}
+
+	void work() {
+		for(;;) {
+			size_t handle;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (queue.empty() && !stopping) queued.wait(lock);
+				if (queue.empty()) return;
+
+				handle = queue.front();
+				queue.pop_front();
+			}
+
+			run(handle);
+		}
+	}
+
+public:
+	///
+	/// Creates a new loader and starts its workers.
+	/// @param workerCount Number of worker threads. With 0, curves are
+	/// loaded when waited for.
+	///
+	CurveLoader(size_t workerCount) : stopping(false) {
+		for(size_t i = 0; i < workerCount; ++i) {
+			workers.push_back(std::thread(&CurveLoader::work, this));
+		}
+	}
+
+	///
+	/// Finishes all loads and stops the workers.
+	///
+	~CurveLoader() {
+		waitAll();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		queued.notify_all();
+
+		for(size_t i = 0; i < workers.size(); ++i) {
+			workers[i].join();
+		}
+	}
+
+	///
+	/// Queue a curve for loading. Knots are copied, so the arrays received
+	/// may be released as soon as this returns.
+	/// @param curve Curve to initialize.
+	/// @param interpolator Interpolator for the curve.
+	/// @param length Number of input and output elements.
+	/// @param inputs Input values, sorted.
+	/// @param outputs Output values.
+	/// @param baker Optional stage to run after initialization.
+	/// @return Handle to query and wait for the load.
+	///
+	size_t load(ParamCurve<TInput, TOutput, maxSize> &curve, Interpolator<TInput, TOutput>* interpolator,
+		size_t length, TInput const *inputs, TOutput const *outputs,
+		CurveBaker<TInput, TOutput, maxSize>* baker = 0) {
+		size_t handle;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			handle = jobs.size();
+			jobs.emplace_back();
+			Job &job = jobs.back();
+			job.curve = &curve;
+			job.interpolator = interpolator;
+			job.inputs.assign(inputs, inputs + length);
+			job.outputs.assign(outputs, outputs + length);
+			job.baker = baker;
+			job.status.store(loadPending);
+			queue.push_back(handle);
+		}
+		queued.notify_one();
+
+		return handle;
+	}
+
+	///
+	/// Obtain the status of a load, without waiting.
+	/// @param handle Handle returned by load.
+	///
+	t_loadStatus getStatus(size_t handle) const {
+		return (t_loadStatus)getJob(handle).status.load(std::memory_order_acquire);
+	}
+
+	///
+	/// Wait for a load to finish. If no worker started it yet, it is run
+	/// on the calling thread.
+	/// @param handle Handle returned by load.
+	/// @return loadReady if the curve was initialized; the failed validation otherwise.
+	///
+	t_loadStatus wait(size_t handle) {
+		run(handle);
+
+		Job &job = getJob(handle);
+		std::unique_lock<std::mutex> lock(mutex);
+		while (job.status.load(std::memory_order_acquire) == loadRunning) finished.wait(lock);
+
+		return (t_loadStatus)job.status.load(std::memory_order_acquire);
+	}
+
+	///
+	/// Wait for all loads queued so far, helping the workers with those not started yet.
+	///
+	void waitAll() {
+		size_t count;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			count = jobs.size();
+		}
+
+		for(size_t handle = 0; handle < count; ++handle) {
+			wait(handle);
+		}
+	}
+};
@@ -26,6 +26,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <type_traits>
+
 enum t_interpolationMode {
 	interpolationClamp
 	, interpolationClampUp
@@ -34,6 +36,92 @@ enum t_interpolationMode {
 	, interpolationSmooth = interpolationCatmullRom
 };
 
+///
+/// Calculates the position of an input inside a segment: 0 at its start, 1 at its end.
+/// The generic version works in float. Specializations keep the precision of
+/// double inputs, and convert integer inputs before dividing, instead of using
+/// integer division. getInput goes the other way, from a ratio between 0 and 1
+/// to an input of the segment.
+/// @tparam TInput Input values type. Required operators:
+/// TInput operator-(TInput&)
+/// TInput operator/(TInput&), convertible to float.
+/// getInput also requires TInput operator+(TInput&) and TInput operator*(float&).
+///
+template<typename TInput>
+struct InterpolationRatio {
+	typedef float type;
+
+	static type get(TInput const &input, TInput const &from, TInput const &to) {
+		return (input - from) / (to - from);
+	}
+
+	static TInput getInput(type ratio, TInput const &from, TInput const &to) {
+		return from + TInput((to - from) * ratio);
+	}
+};
+
+template<>
+struct InterpolationRatio<double> {
+	typedef double type;
+
+	static type get(double input, double from, double to) {
+		return (input - from) / (to - from);
+	}
+
+	static double getInput(type ratio, double from, double to) {
+		return from + (to - from) * ratio;
+	}
+};
+
+template<>
+struct InterpolationRatio<long double> {
+	typedef long double type;
+
+	static type get(long double input, long double from, long double to) {
+		return (input - from) / (to - from);
+	}
+
+	static long double getInput(type ratio, long double from, long double to) {
+		return from + (to - from) * ratio;
+	}
+};
+
+///
+/// Ratio of integer inputs. Differences are taken in the unsigned type, where
+/// they are exact as long as from <= input <= to, even for signed ranges wider
+/// than the type holds (as from -2e9 to 2e9 in int), and only then converted
+/// to float. getInput rounds toward from, and never goes past to.
+///
+template<typename TInput>
+struct IntegerInterpolationRatio {
+	typedef float type;
+	typedef typename std::make_unsigned<TInput>::type TUnsigned;
+
+	static type get(TInput input, TInput from, TInput to) {
+		return (float)TUnsigned(TUnsigned(input) - TUnsigned(from)) / (float)TUnsigned(TUnsigned(to) - TUnsigned(from));
+	}
+
+	static TInput getInput(type ratio, TInput from, TInput to) {
+		TUnsigned difference = TUnsigned(TUnsigned(to) - TUnsigned(from));
+		long double offset = (long double)difference * ratio;
+		if (!((long double)difference > offset)) return to;
+		if (!(offset > 0.L)) return from;
+		return TInput(TUnsigned(TUnsigned(from) + TUnsigned(offset)));
+	}
+};
+
+template<> struct InterpolationRatio<char> : IntegerInterpolationRatio<char> {};
+template<> struct InterpolationRatio<signed char> : IntegerInterpolationRatio<signed char> {};
+template<> struct InterpolationRatio<unsigned char> : IntegerInterpolationRatio<unsigned char> {};
+template<> struct InterpolationRatio<short> : IntegerInterpolationRatio<short> {};
+template<> struct InterpolationRatio<unsigned short> : IntegerInterpolationRatio<unsigned short> {};
+template<> struct InterpolationRatio<int> : IntegerInterpolationRatio<int> {};
+template<> struct InterpolationRatio<unsigned int> : IntegerInterpolationRatio<unsigned int> {};
+template<> struct InterpolationRatio<long> : IntegerInterpolationRatio<long> {};
+template<> struct InterpolationRatio<unsigned long> : IntegerInterpolationRatio<unsigned long> {};
+template<> struct InterpolationRatio<long long> : IntegerInterpolationRatio<long long> {};
+template<> struct InterpolationRatio<unsigned long long> : IntegerInterpolationRatio<unsigned long long> {};
+
 ///
 /// Abstract implementation of an interpolator.
 /// @tparam TInput Input values type.
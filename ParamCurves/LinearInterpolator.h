@@ -38,7 +38,8 @@ SOFTWARE.
 /// @tparam TOutput Output values type. Required operators:
 /// TOuput operator+(TOutput&)
 /// TOuput operator-(TOutput&)
-/// TOutput operator*(float&).
+/// TOutput operator*(float&), or operator*(double&) for double inputs.
+/// @see InterpolationRatio for the precision of each input type.
 ///
 template<typename TInput, typename TOutput>
 class LinearInterpolator : public Interpolator<TInput, TOutput> {
@@ -50,6 +51,15 @@ public:
 		return &instance;
 	}
 
+	///
+	/// Calculate the output for an input inside the segment starting at index,
+	/// that is, inputs[index] <= input < inputs[index+1].
+	///
+	static TOutput interpolateSegment(TInput input, size_t index, TInput const *inputs, TOutput const *outputs, size_t) {
+		typename InterpolationRatio<TInput>::type ratio = InterpolationRatio<TInput>::get(input, inputs[index], inputs[index+1]);
+		return outputs[index] + ((outputs[index+1] - outputs[index]) * ratio);
+	}
+
 	TOutput interpolate(TInput input, TInput const *inputs, TOutput const *outputs, size_t size) {
 		if (size == 0) return 0;
 		if (input <= inputs[0]) return outputs[0];
@@ -57,8 +67,7 @@ public:
 
 		for(size_t i = 0; i < size; ++i) {
 			if (inputs[i] <= input && input < inputs[i+1]) {
-				float ratio = (input - inputs[i]) / (inputs[i+1] - inputs[i]);
-				return outputs[i] + ((outputs[i+1] - outputs[i]) * ratio);
+				return interpolateSegment(input, i, inputs, outputs, size);
 			}
 		}
 
@@ -0,0 +1,155 @@
+///
+/// @file MemoCache.h Memoization of curve results for repeated inputs.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include <string.h>
+#include "ParamCurve.h"
+
+///
+/// Small direct-mapped cache of ParamCurve results, keyed on the curve and
+/// the bit pattern of the input. Useful when a curve is evaluated over and over with a few
+/// discrete inputs (integer levels, enumerated values...).
+/// An instance may be kept next to a single curve or shared by several curves
+/// (i.e. one instance per thread), since entries also remember the curve they
+/// belong to. Entries are discarded when their curve is initialized again.
+/// The cache is not thread safe; do not share one instance between threads.
+/// @tparam TInput Input values type. Compared bitwise, so it should be a plain
+/// type without padding (float, double, int...).
+/// @tparam TOutput Output values type. Must be copyable.
+/// @tparam maxSize Maximum size of the curves evaluated through the cache.
+/// @tparam cacheSize Number of entries in the cache.
+///
+template<typename TInput, typename TOutput, size_t maxSize, size_t cacheSize = 64>
+class MemoCache {
+	struct Entry {
+		ParamCurve<TInput, TOutput, maxSize> const *curve;
+		unsigned long long version;
+		TInput input;
+		TOutput output;
+	};
+
+	Entry entries[cacheSize];
+	unsigned long hits;
+	unsigned long misses;
+
+	static unsigned long hashBytes(void const *data, size_t size) {
+		// FNV-1a, with a final mix so that values differing only in their
+		// high bytes (small floats) spread out.
+		unsigned char const *bytes = reinterpret_cast<unsigned char const *>(data);
+		unsigned long result = 2166136261UL;
+		for(size_t i = 0; i < size; ++i) {
+			result ^= bytes[i];
+			result = (result * 16777619UL) & 0xffffffffUL;
+		}
+		result ^= result >> 16;
+		result = (result * 0x85ebca6bUL) & 0xffffffffUL;
+		result ^= result >> 13;
+
+		return result;
+	}
+
+	static size_t hash(ParamCurve<TInput, TOutput, maxSize> const *curve, TInput const &input) {
+		// The curve rotates the entries of its inputs, so that curves sharing
+		// the cache do not all compete for the same entries, while the inputs
+		// of each curve keep apart from each other as without sharing.
+		size_t inputSlot = (size_t)(hashBytes(&input, sizeof(TInput)) % cacheSize);
+		size_t curveOffset = (size_t)(hashBytes(&curve, sizeof(curve)) % cacheSize);
+		return (inputSlot + curveOffset) % cacheSize;
+	}
+
+public:
+	///
+	/// Creates a new, empty, cache.
+	///
+	MemoCache() : hits(0), misses(0) {
+		clear();
+	}
+
+	///
+	/// Discard all cached results. Statistics are kept.
+	///
+	void clear() {
+		for(size_t i = 0; i < cacheSize; ++i) {
+			entries[i].curve = 0;
+		}
+	}
+
+	///
+	/// Obtain the output value corresponding to the input received,
+	/// reusing the last result for the same curve and input if still cached.
+	/// @param curve Curve to evaluate.
+	/// @param input The value to calculate an output for.
+	/// @return The same value as curve.getValue(input).
+	///
+	TOutput getValue(ParamCurve<TInput, TOutput, maxSize> const &curve, TInput input) {
+		Entry &entry = entries[hash(&curve, input)];
+		if (entry.curve == &curve
+			&& entry.version == curve.getVersion()
+			&& memcmp(&entry.input, &input, sizeof(TInput)) == 0) {
+			++hits;
+			return entry.output;
+		}
+
+		++misses;
+		entry.curve = &curve;
+		entry.version = curve.getVersion();
+		entry.input = input;
+		entry.output = curve.getValue(input);
+		return entry.output;
+	}
+
+	///
+	/// Obtain the number of lookups answered from the cache.
+	///
+	unsigned long getHits() const {
+		return hits;
+	}
+
+	///
+	/// Obtain the number of lookups that required evaluating the curve.
+	///
+	unsigned long getMisses() const {
+		return misses;
+	}
+
+	///
+	/// Obtain the ratio of lookups answered from the cache.
+	/// @return Value between 0 and 1; 0 if no lookups were made.
+	///
+	float getHitRate() const {
+		if (hits + misses == 0) return 0.f;
+		return (float)hits / (float)(hits + misses);
+	}
+
+	///
+	/// Reset hit and miss counters.
+	///
+	void resetStatistics() {
+		hits = 0;
+		misses = 0;
+	}
+};
@@ -26,8 +26,18 @@ SOFTWARE.
 
 #pragma once
 
+#include <atomic>
 #include "Interpolator.h"
 
+///
+/// Obtain a value never returned before, shared by all curves, to identify
+/// the contents of a curve.
+///
+inline unsigned long long newCurveVersion() {
+	static std::atomic<unsigned long long> lastVersion(0);
+	return ++lastVersion;
+}
+
 ///
 /// Stores a parameterized curve and returns the output values corresponding
 /// to a specific input value.
@@ -42,14 +52,16 @@ template<typename TInput, typename TOutput, size_t maxSize>
 class ParamCurve {
 	Interpolator<TInput, TOutput>* interpolator;
 	size_t length;
+	unsigned long long version;
 	TInput inputs[maxSize];
 	TOutput outputs[maxSize];
 
 public:
 	///
 	/// Creates a new instance of ParamCurve, with no elements.
+	/// Empty curves share version 0, as there is nothing to cache for them.
 	///
-	ParamCurve() : length(0) {}
+	ParamCurve() : interpolator(0), length(0), version(0) {}
 
 	///
 	/// Initialize the curve with the desired input and output values, plus the interpolator.
@@ -68,6 +80,19 @@ public:
 			inputs[i] = newInputs[i];
 			outputs[i] = newOutputs[i];
 		}
+
+		version = newCurveVersion();
+	}
+
+	///
+	/// Obtain the version of the curve contents. Each call to initialize gets
+	/// a version no other curve had before; copies keep the version along
+	/// with the contents. Helpers caching results for this curve
+	/// compare it to detect stale data, even if a new curve reuses the address.
+	/// @return Current version of the curve contents.
+	///
+	unsigned long long getVersion() const {
+		return version;
 	}
 
 	///
@@ -88,6 +113,37 @@ public:
 		return inputs[maxSize - 1];
 	}
 
+	///
+	/// Obtain the number of input and output elements in store.
+	///
+	size_t getLength() const {
+		return length;
+	}
+
+	///
+	/// Obtain the input value stored at a given position.
+	/// @param index Position of the element, lower than getLength().
+	///
+	TInput const &getInput(size_t index) const {
+		return inputs[index];
+	}
+
+	///
+	/// Obtain the output value stored at a given position.
+	/// @param index Position of the element, lower than getLength().
+	///
+	TOutput const &getOutput(size_t index) const {
+		return outputs[index];
+	}
+
+	///
+	/// Obtain the interpolator used to calculate values.
+	/// @return The interpolator received on initialize; 0 if not initialized.
+	///
+	Interpolator<TInput, TOutput>* getInterpolator() const {
+		return interpolator;
+	}
+
 	///
 	/// Obtain the output value corresponding to the input received,
 	/// calculated using the selected interpolator.
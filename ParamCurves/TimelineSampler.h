@@ -0,0 +1,292 @@
+///
+/// @file TimelineSampler.h Evaluation of many curves at the same input.
+/// @author Enrique Juan Gil Izquierdo
+///
+/**
+Copyright (c) 2012 Enrique Juan Gil Izquierdo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**/
+
+#pragma once
+
+#include "ParamCurve.h"
+#include "ClampInterpolator.h"
+#include "ClampUpInterpolator.h"
+#include "LinearInterpolator.h"
+#include "CatmullRomInterpolator.h"
+
+///
+/// Evaluates a set of curves (tracks) at a shared input, such as the time of
+/// an animation. Each track remembers the segment used last time, so inputs
+/// moving forward or backward little by little find their segment right away.
+/// Tracks are evaluated in batches of the same interpolator, without virtual
+/// calls, and tracks staying inside a constant segment are not evaluated again.
+/// Tracks are referenced, not copied: they must outlive the sampler. Tracks
+/// initialized again are detected on the next call to sample.
+/// @tparam TInput Input values type. Requires the operators required by
+/// LinearInterpolator and CatmullRomInterpolator.
+/// @tparam TOutput Output values type. Requires the operators required by
+/// LinearInterpolator and CatmullRomInterpolator, plus
+/// bool operator==(TOutput&).
+/// @tparam maxSize Maximum size of the curves.
+/// @tparam maxTracks Maximum number of tracks.
+///
+template<typename TInput, typename TOutput, size_t maxSize, size_t maxTracks>
+class TimelineSampler {
+	enum t_group {
+		groupClamp
+		, groupClampUp
+		, groupLinear
+		, groupCatmullRom
+		, groupOther
+		, groupCount
+	};
+
+	///
+	/// Sampling state of a curve. Regions are numbered so that 0 is the input
+	/// range before the first input, length the range after the last input,
+	/// and any other region the segment starting at inputs[region - 1].
+	///
+	struct Track {
+		ParamCurve<TInput, TOutput, maxSize> const *curve;
+		unsigned long long version;
+		size_t region;
+		bool evaluated;
+		bool constant[maxSize + 1];
+	};
+
+	Track tracks[maxTracks];
+	TOutput values[maxTracks];
+	size_t trackCount;
+	size_t groups[groupCount][maxTracks];
+	size_t groupSizes[groupCount];
+	bool groupsDirty;
+	size_t skipped;
+
+	static t_group getGroup(ParamCurve<TInput, TOutput, maxSize> const &curve) {
+		Interpolator<TInput, TOutput>* interpolator = curve.getInterpolator();
+		if (interpolator == 0 || curve.getLength() == 0) return groupOther;
+		if (interpolator == ClampInterpolator<TInput, TOutput>::getInstance()) return groupClamp;
+		if (interpolator == ClampUpInterpolator<TInput, TOutput>::getInstance()) return groupClampUp;
+		if (interpolator == LinearInterpolator<TInput, TOutput>::getInstance()) return groupLinear;
+		if (interpolator == CatmullRomInterpolator<TInput, TOutput>::getInstance()) return groupCatmullRom;
+		return groupOther;
+	}
+
+	///
+	/// Reset the state of a track after its curve changed, finding which of
+	/// its segments are constant.
+	///
+	static void refresh(Track &track) {
+		ParamCurve<TInput, TOutput, maxSize> const &curve = *track.curve;
+		size_t length = curve.getLength();
+		t_group group = getGroup(curve);
+
+		track.version = curve.getVersion();
+		track.region = 0;
+		track.evaluated = false;
+		for(size_t region = 0; region <= length; ++region) {
+			if (region == 0 || region == length || group == groupClamp || group == groupClampUp) {
+				track.constant[region] = true;
+				continue;
+			}
+
+			size_t i = region - 1;
+			TOutput const &v1 = curve.getOutput(i);
+			TOutput const &v2 = curve.getOutput(i + 1);
+			if (group == groupLinear) {
+				track.constant[region] = v1 == v2;
+			}
+			else if (group == groupCatmullRom) {
+				TOutput const &c1 = (i > 0) ? curve.getOutput(i - 1) : v1;
+				TOutput const &c2 = (i + 2 < length) ? curve.getOutput(i + 2) : v2;
+				track.constant[region] = c1 == v1 && v1 == v2 && v2 == c2;
+			}
+			else {
+				track.constant[region] = false;
+			}
+		}
+	}
+
+	///
+	/// Check whether input belongs to a region of the curve.
+	///
+	static bool isInRegion(TInput input, size_t region, TInput const *inputs, size_t length) {
+		// As in Interpolator::interpolate, inputs up to the first one go before
+		// any segment, even with duplicated inputs.
+		if (region == 0) return input <= inputs[0];
+		if (!(inputs[0] < input)) return false;
+		if (region == length) return inputs[length - 1] <= input;
+		return inputs[region - 1] <= input && input < inputs[region];
+	}
+
+	///
+	/// Find the region of the curve containing input, walking from a known region.
+	/// Inputs not belonging to any segment (malformed curves) go after the last input,
+	/// as with Interpolator::interpolate.
+	///
+	static size_t findRegion(TInput input, size_t region, TInput const *inputs, size_t length) {
+		if (input <= inputs[0]) return 0;
+		if (inputs[length - 1] <= input || length < 2) return length;
+
+		size_t i = (region == 0) ? 0 : region - 1;
+		if (i > length - 2) i = length - 2;
+		while (i > 0 && input < inputs[i]) --i;
+		while (i < length - 2 && !(input < inputs[i + 1])) ++i;
+
+		if (inputs[i] <= input && input < inputs[i + 1]) return i + 1;
+		return length;
+	}
+
+	void updateGroups() {
+		for(size_t group = 0; group < groupCount; ++group) {
+			groupSizes[group] = 0;
+		}
+
+		for(size_t track = 0; track < trackCount; ++track) {
+			t_group group = getGroup(*tracks[track].curve);
+			groups[group][groupSizes[group]++] = track;
+		}
+
+		groupsDirty = false;
+	}
+
+	///
+	/// Evaluate all tracks using the same interpolator.
+	///
+	template<typename TInterpolator>
+	void sampleGroup(TInput input, size_t const *group, size_t groupSize) {
+		for(size_t k = 0; k < groupSize; ++k) {
+			size_t index = group[k];
+			Track &track = tracks[index];
+			ParamCurve<TInput, TOutput, maxSize> const &curve = *track.curve;
+			size_t length = curve.getLength();
+			TInput const *inputs = &curve.getInput(0);
+			TOutput const *outputs = &curve.getOutput(0);
+
+			if (isInRegion(input, track.region, inputs, length)) {
+				if (track.evaluated && track.constant[track.region]) {
+					++skipped;
+					continue;
+				}
+			}
+			else {
+				track.region = findRegion(input, track.region, inputs, length);
+			}
+
+			if (track.region == 0) values[index] = outputs[0];
+			else if (track.region == length) values[index] = outputs[length - 1];
+			else values[index] = TInterpolator::interpolateSegment(input, track.region - 1, inputs, outputs, length);
+			track.evaluated = true;
+		}
+	}
+
+public:
+	///
+	/// Creates a new sampler, with no tracks.
+	///
+	TimelineSampler() : trackCount(0), groupsDirty(false), skipped(0) {
+		for(size_t group = 0; group < groupCount; ++group) {
+			groupSizes[group] = 0;
+		}
+	}
+
+	///
+	/// Add a curve to the set of tracks. Its value is available after the next
+	/// call to sample, at the position given by the number of tracks added before.
+	/// @param curve Curve to evaluate on each call to sample.
+	/// @return false if there is no room for more tracks.
+	///
+	bool addTrack(ParamCurve<TInput, TOutput, maxSize> const &curve) {
+		if (trackCount >= maxTracks) return false;
+
+		Track &track = tracks[trackCount++];
+		track.curve = &curve;
+		refresh(track);
+		groupsDirty = true;
+		return true;
+	}
+
+	///
+	/// Remove all tracks.
+	///
+	void clear() {
+		trackCount = 0;
+		groupsDirty = true;
+	}
+
+	///
+	/// Obtain the number of tracks.
+	///
+	size_t getTrackCount() const {
+		return trackCount;
+	}
+
+	///
+	/// Evaluate all tracks at the same input.
+	/// @param input The value to calculate outputs for.
+	///
+	void sample(TInput input) {
+		for(size_t index = 0; index < trackCount; ++index) {
+			Track &track = tracks[index];
+			if (track.version != track.curve->getVersion()) {
+				refresh(track);
+				groupsDirty = true;
+			}
+		}
+
+		if (groupsDirty) updateGroups();
+
+		skipped = 0;
+		sampleGroup<ClampInterpolator<TInput, TOutput> >(input, groups[groupClamp], groupSizes[groupClamp]);
+		sampleGroup<ClampUpInterpolator<TInput, TOutput> >(input, groups[groupClampUp], groupSizes[groupClampUp]);
+		sampleGroup<LinearInterpolator<TInput, TOutput> >(input, groups[groupLinear], groupSizes[groupLinear]);
+		sampleGroup<CatmullRomInterpolator<TInput, TOutput> >(input, groups[groupCatmullRom], groupSizes[groupCatmullRom]);
+
+		for(size_t k = 0; k < groupSizes[groupOther]; ++k) {
+			size_t index = groups[groupOther][k];
+			values[index] = tracks[index].curve->getValue(input);
+		}
+	}
+
+	///
+	/// Obtain the value of a track calculated by the last call to sample.
+	/// @param track Position of the track, lower than getTrackCount().
+	///
+	TOutput const &getValue(size_t track) const {
+		return values[track];
+	}
+
+	///
+	/// Obtain the values of all tracks calculated by the last call to sample.
+	/// @return Array of getTrackCount() values, in the order tracks were added.
+	///
+	TOutput const *getValues() const {
+		return values;
+	}
+
+	///
+	/// Obtain the number of tracks that were not evaluated in the last call
+	/// to sample, because they stayed in a constant segment.
+	///
+	size_t getSkippedCount() const {
+		return skipped;
+	}
+};